@@ -309,6 +309,31 @@ FT_TS_BEGIN_HEADER
 #define FT_TS_CONFIG_OPTION_USE_BROTLI
 
 
+  /**************************************************************************
+   *
+   * Shared small bitmap cache.
+   *
+   *   Define this macro to let the cache sub-system share rendered small
+   *   bitmaps between processes through a POSIX shared memory segment; see
+   *   `FTC_SharedCache_Open` in `ftcache.h`.  It needs `shm_open` and GCC
+   *   style atomic builtins.  If undefined, the shared cache functions
+   *   return `FT_TS_Err_Unimplemented_Feature`.
+   */
+/* #define FT_TS_CONFIG_OPTION_SHARED_CACHE */
+
+
+  /**************************************************************************
+   *
+   * Multithreaded SDF generation.
+   *
+   *   Define this macro to let the 'sdf' renderer distribute the rows of
+   *   large glyphs over several POSIX threads, up to the number given by
+   *   its `threads` property; the output is the same as with one thread.
+   *   You then have to link with the thread library (e.g., `-lpthread`).
+   */
+/* #define FT_TS_CONFIG_OPTION_SDF_THREADS */
+
+
   /**************************************************************************
    *
    * Glyph Postscript Names handling
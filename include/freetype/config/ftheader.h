@@ -677,6 +677,18 @@
 #define FT_TS_STROKER_H  <freetype/ftstroke.h>
 
 
+  /**************************************************************************
+   *
+   * @macro:
+   *   FT_TS_CANVAS_H
+   *
+   * @description:
+   *   A macro used in `#include` statements to name the file containing the
+   *   FreeType~2 API which renders glyphs directly into client surfaces.
+   */
+#define FT_TS_CANVAS_H  <freetype/ftcanvas.h>
+
+
   /**************************************************************************
    *
    * @macro:
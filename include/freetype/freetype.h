@@ -326,6 +326,8 @@ FT_TS_BEGIN_HEADER
    *   FT_TS_LOAD_TARGET_MONO
    *   FT_TS_LOAD_TARGET_LCD
    *   FT_TS_LOAD_TARGET_LCD_V
+   *   FT_TS_LOAD_TARGET_GRAY2
+   *   FT_TS_LOAD_TARGET_GRAY4
    *
    *   FT_TS_LOAD_TARGET_MODE
    *
@@ -3405,6 +3407,13 @@ FT_TS_BEGIN_HEADER
    *     A variant of @FT_TS_LOAD_TARGET_NORMAL optimized for vertically
    *     decimated LCD displays.
    *
+   *   FT_TS_LOAD_TARGET_GRAY2 ::
+   *   FT_TS_LOAD_TARGET_GRAY4 ::
+   *     The same hinting as @FT_TS_LOAD_TARGET_NORMAL, selecting
+   *     @FT_TS_RENDER_MODE_GRAY2 and @FT_TS_RENDER_MODE_GRAY4,
+   *     respectively, if @FT_TS_LOAD_RENDER is set.  The caches store the
+   *     resulting packed bitmaps as they are.
+   *
    * @note:
    *   You should use only _one_ of the `FT_TS_LOAD_TARGET_XXX` values in your
    *   `load_flags`.  They can't be ORed.
@@ -3441,6 +3450,8 @@ FT_TS_BEGIN_HEADER
 #define FT_TS_LOAD_TARGET_MONO    FT_TS_LOAD_TARGET_( FT_TS_RENDER_MODE_MONO   )
 #define FT_TS_LOAD_TARGET_LCD     FT_TS_LOAD_TARGET_( FT_TS_RENDER_MODE_LCD    )
 #define FT_TS_LOAD_TARGET_LCD_V   FT_TS_LOAD_TARGET_( FT_TS_RENDER_MODE_LCD_V  )
+#define FT_TS_LOAD_TARGET_GRAY2   FT_TS_LOAD_TARGET_( FT_TS_RENDER_MODE_GRAY2  )
+#define FT_TS_LOAD_TARGET_GRAY4   FT_TS_LOAD_TARGET_( FT_TS_RENDER_MODE_GRAY4  )
 
 
   /**************************************************************************
@@ -3545,8 +3556,9 @@ FT_TS_BEGIN_HEADER
    *   in the @FT_TS_GlyphSlotRec structure gives the format of the returned
    *   bitmap.
    *
-   *   All modes except @FT_TS_RENDER_MODE_MONO use 256 levels of opacity,
-   *   indicating pixel coverage.  Use linear alpha blending and gamma
+   *   All modes except @FT_TS_RENDER_MODE_MONO, @FT_TS_RENDER_MODE_GRAY2,
+   *   and @FT_TS_RENDER_MODE_GRAY4 use 256 levels of opacity, indicating
+   *   pixel coverage.  Use linear alpha blending and gamma
    *   correction to correctly render non-monochrome glyph bitmaps onto a
    *   surface; see @FT_TS_Render_Glyph.
    *
@@ -3588,6 +3600,18 @@ FT_TS_BEGIN_HEADER
    *     otherwise.  Check the note below on how to convert the output values
    *     to usable data.
    *
+   *   FT_TS_RENDER_MODE_GRAY2 ::
+   *     This mode corresponds to packed 2-bit anti-aliased bitmaps (with
+   *     4~levels of opacity) in the @FT_TS_PIXEL_MODE_GRAY2 mode, for
+   *     displays with few gray levels.  The coverage is quantized while
+   *     rendering, optionally with ordered dithering (see the
+   *     @gray-dither property of the 'smooth' renderer).
+   *
+   *   FT_TS_RENDER_MODE_GRAY4 ::
+   *     The same as @FT_TS_RENDER_MODE_GRAY2, producing packed 4-bit
+   *     bitmaps (with 16~levels of opacity) in the @FT_TS_PIXEL_MODE_GRAY4
+   *     mode.
+   *
    * @note:
    *   The selected render mode only affects vector glyphs of a font.
    *   Embedded bitmaps often have a different pixel mode like
@@ -3669,6 +3693,8 @@ FT_TS_BEGIN_HEADER
     FT_TS_RENDER_MODE_LCD,
     FT_TS_RENDER_MODE_LCD_V,
     FT_TS_RENDER_MODE_SDF,
+    FT_TS_RENDER_MODE_GRAY2,
+    FT_TS_RENDER_MODE_GRAY4,
 
     FT_TS_RENDER_MODE_MAX
 
@@ -173,6 +173,42 @@ FT_TS_BEGIN_HEADER
                      FT_TS_Int            alignment );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Bitmap_Convert_Into
+   *
+   * @description:
+   *   Convert a bitmap object with depth 1bpp, 2bpp, 4bpp, 8bpp or 32bpp to
+   *   depth 8bpp, like @FT_TS_Bitmap_Convert, but into a buffer provided by
+   *   the caller.
+   *
+   * @input:
+   *   source ::
+   *     The source bitmap.
+   *
+   * @inout:
+   *   target ::
+   *     The target bitmap.  On input, its `buffer` and `pitch` fields must
+   *     describe a buffer large enough for `source->rows` lines of
+   *     `source->width` bytes; the sign of `pitch` gives the bitmap flow.
+   *     On output, the remaining fields are set.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   No memory is allocated; this is useful to convert many bitmaps (for
+   *   example, embedded bitmaps) into a single scratch buffer.
+   *
+   *   `source->buffer` and `target->buffer` must neither be equal nor
+   *   overlap.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Bitmap_Convert_Into( const FT_TS_Bitmap*  source,
+                          FT_TS_Bitmap*        target );
+
+
   /**************************************************************************
    *
    * @function:
@@ -21,6 +21,7 @@
 
 
 #include <freetype/ftglyph.h>
+#include <freetype/ftstroke.h>
 
 
 FT_TS_BEGIN_HEADER
@@ -96,6 +97,22 @@ FT_TS_BEGIN_HEADER
    *   directly.  (A small bitmap is one whose metrics and dimensions all fit
    *   into 8-bit integers).
    *
+   *   To avoid a cold cache after a restart, a running manager can record
+   *   which glyphs are requested from its image and sbit caches with
+   *   @FTC_Manager_RecordUsage.  The resulting histogram is serialized with
+   *   @FTC_Manager_SaveUsage and replayed at startup with
+   *   @FTC_Manager_Prewarm, which loads the hottest glyphs first.
+   *
+   *   Processes that render the same fonts can additionally share their
+   *   small bitmaps through a store in shared memory; see
+   *   @FTC_SharedCache_Open and @FTC_SBitCache_SetShared.
+   *
+   *   Signed distance fields, which can be drawn at many scales from a
+   *   single rendering, are cached with @FTC_SDFCache_New and
+   *   @FTC_SDFCache_Lookup.  Stroked glyphs, for example for outlined
+   *   text, are cached with @FTC_StrokeCache_New and
+   *   @FTC_StrokeCache_Lookup.
+   *
    *   We hope to also provide a kerning cache in the near future.
    *
    *
@@ -127,6 +144,17 @@ FT_TS_BEGIN_HEADER
    *   FTC_CMapCache_New
    *   FTC_CMapCache_Lookup
    *
+   *   FTC_FaceID_ToKey
+   *   FTC_FaceID_FromKey
+   *   FTC_Manager_RecordUsage
+   *   FTC_Manager_SaveUsage
+   *   FTC_Manager_Prewarm
+   *
+   *   FTC_SharedCache
+   *   FTC_SharedCache_Open
+   *   FTC_SharedCache_Close
+   *   FTC_SBitCache_SetShared
+   *
    *************************************************************************/
 
 
@@ -886,7 +914,10 @@ FT_TS_BEGIN_HEADER
    *     positive for upwards y~coordinates.
    *
    *   format ::
-   *     The format of the glyph bitmap (monochrome or gray).
+   *     The format of the glyph bitmap (monochrome or gray).  Outlines
+   *     loaded with @FT_TS_LOAD_TARGET_GRAY2 or @FT_TS_LOAD_TARGET_GRAY4
+   *     are stored as packed @FT_TS_PIXEL_MODE_GRAY2 or
+   *     @FT_TS_PIXEL_MODE_GRAY4 bitmaps.
    *
    *   max_grays ::
    *     Maximum gray level value (in the range 1 to~255).
@@ -1076,6 +1107,746 @@ FT_TS_BEGIN_HEADER
                               FTC_SBit      *sbit,
                               FTC_Node      *anode );
 
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                        USAGE PROFILES                         *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_FaceID_ToKey
+   *
+   * @description:
+   *   A callback function provided by client applications to convert an
+   *   @FTC_FaceID into a persistent 32-bit key, for example an index into
+   *   the application's font list.  It is used by @FTC_Manager_SaveUsage.
+   *
+   * @input:
+   *   face_id ::
+   *     The face ID to convert.
+   *
+   *   key_data ::
+   *     Application-provided data, as passed to @FTC_Manager_SaveUsage.
+   *
+   * @return:
+   *   The key of the face.
+   */
+  typedef FT_TS_ULong
+  (*FTC_FaceID_ToKey)( FTC_FaceID     face_id,
+                       FT_TS_Pointer  key_data );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FTC_FaceID_FromKey
+   *
+   * @description:
+   *   The inverse of @FTC_FaceID_ToKey, used by @FTC_Manager_Prewarm to
+   *   map a key stored in a usage profile back to an @FTC_FaceID.
+   *
+   * @input:
+   *   face_key ::
+   *     The key of the face.
+   *
+   *   key_data ::
+   *     Application-provided data, as passed to @FTC_Manager_Prewarm.
+   *
+   * @return:
+   *   The face ID, or `NULL` if the face is no longer available; its
+   *   glyphs are then skipped.
+   */
+  typedef FTC_FaceID
+  (*FTC_FaceID_FromKey)( FT_TS_ULong    face_key,
+                         FT_TS_Pointer  key_data );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_RecordUsage
+   *
+   * @description:
+   *   Start or stop recording a glyph usage histogram.  While recording is
+   *   active, every successful lookup in an @FTC_ImageCache or
+   *   @FTC_SBitCache of the manager increments a counter for the
+   *   requested glyph, grouped by face, scaler, and load flags.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   *   enable ::
+   *     If true, start recording; recording into an already existing
+   *     histogram continues.  If false, stop recording and discard the
+   *     histogram.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The histogram is also updated by @FTC_Manager_RemoveFaceID, which
+   *   drops all counters related to the removed face.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_Manager_RecordUsage( FTC_Manager  manager,
+                           FT_TS_Bool   enable );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_SaveUsage
+   *
+   * @description:
+   *   Serialize the glyph usage histogram recorded by a cache manager into
+   *   a compact, platform-independent byte sequence.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   *   to_key ::
+   *     A callback to convert face IDs into persistent keys.  It must not
+   *     be `NULL`, since face IDs are usually pointers, which neither
+   *     persist nor fit into a 32-bit key.
+   *
+   *   key_data ::
+   *     Passed to `to_key`.
+   *
+   *   buffer ::
+   *     The target buffer.  If `NULL`, only the needed length is computed.
+   *
+   * @inout:
+   *   length ::
+   *     On input, the size of `buffer`.  On output, the number of bytes
+   *     written (or needed if `buffer` is `NULL`).
+   *
+   * @return:
+   *   FreeType error code.  0~means success.  `FT_TS_Err_Array_Too_Large`
+   *   is returned if the buffer is too small.
+   *
+   * @note:
+   *   Usage recording must have been started with
+   *   @FTC_Manager_RecordUsage.
+   *
+   *   As with @FT_TS_Load_Sfnt_Table, call this function twice: first with
+   *   a `NULL` buffer to get the length, then with a buffer of that size.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_Manager_SaveUsage( FTC_Manager       manager,
+                         FTC_FaceID_ToKey  to_key,
+                         FT_TS_Pointer     key_data,
+                         FT_TS_Byte*       buffer,
+                         FT_TS_ULong*      length );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_Manager_Prewarm
+   *
+   * @description:
+   *   Replay a usage profile created by @FTC_Manager_SaveUsage, loading
+   *   the recorded glyphs into the given caches in order of decreasing
+   *   hit count.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the cache manager.
+   *
+   *   image_cache ::
+   *     The image cache to fill.  If `NULL`, glyphs recorded for image
+   *     caches are skipped.
+   *
+   *   sbit_cache ::
+   *     The sbit cache to fill.  If `NULL`, glyphs recorded for sbit
+   *     caches are skipped.
+   *
+   *   buffer ::
+   *     The profile data.
+   *
+   *   length ::
+   *     The length of `buffer` in bytes.
+   *
+   *   from_key ::
+   *     A callback to convert the stored face keys back into face IDs.  If
+   *     `NULL`, the keys are used as face IDs.
+   *
+   *   key_data ::
+   *     Passed to `from_key`.
+   *
+   *   max_glyphs ::
+   *     The maximum number of glyphs to load in this call.  Use value~0
+   *     to replay the whole profile.
+   *
+   * @inout:
+   *   acursor ::
+   *     The index of the first profile entry to replay, counting from the
+   *     hottest glyph; updated to the index of the next entry on return.
+   *     Can be `NULL` to always start with the hottest glyph.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Replay stops as soon as the manager reaches its `max_bytes` limit,
+   *   since loading more glyphs would only evict hotter ones; the cursor
+   *   is then moved past the last entry.  Glyphs that can't be loaded are
+   *   skipped.
+   *
+   *   Like all cache functions, this function is not thread-safe.  To keep
+   *   a server responsive during startup, pass a small `max_glyphs` value
+   *   and call it repeatedly, for example from an idle handler or between
+   *   requests on the thread that owns the manager, until `*acursor` no
+   *   longer changes.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_Manager_Prewarm( FTC_Manager         manager,
+                       FTC_ImageCache      image_cache,
+                       FTC_SBitCache       sbit_cache,
+                       const FT_TS_Byte*   buffer,
+                       FT_TS_ULong         length,
+                       FTC_FaceID_FromKey  from_key,
+                       FT_TS_Pointer       key_data,
+                       FT_TS_UInt          max_glyphs,
+                       FT_TS_UInt         *acursor );
+
+  /* */
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                     SHARED BITMAP STORE                       *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_SharedCache
+   *
+   * @description:
+   *   A handle to a store of small bitmaps in POSIX shared memory, which
+   *   can be attached to the @FTC_SBitCache objects of several processes.
+   *   A glyph rendered by one process is then available to all other
+   *   processes without rendering it again, and its bitmap is kept only
+   *   once in memory.
+   *
+   *   The store is append-only: entries are never evicted, and glyphs no
+   *   longer fitting into it are simply kept in the private cache.
+   *
+   *   This feature needs the configuration macro
+   *   `FT_TS_CONFIG_OPTION_SHARED_CACHE`.
+   */
+  typedef struct FTC_SharedCacheRec_*  FTC_SharedCache;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_SharedCache_Open
+   *
+   * @description:
+   *   Create a new shared bitmap store, or attach to an existing one with
+   *   the same name.
+   *
+   * @input:
+   *   library ::
+   *     The parent FreeType library handle to use for allocations.
+   *
+   *   name ::
+   *     The name of the shared memory object, as expected by `shm_open`,
+   *     for example `/myapp-glyphs`.
+   *
+   *   size ::
+   *     The size of the store in bytes, at most 2GByte.  Ignored when
+   *     attaching to an existing store.
+   *
+   * @output:
+   *   ashared ::
+   *     A handle to the store.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *   `FT_TS_Err_Unimplemented_Feature` is returned if the library was
+   *   built without shared cache support.
+   *
+   * @note:
+   *   Glyphs are identified by a checksum of the font file's naming and
+   *   header data instead of the face ID, so processes may use different
+   *   face IDs for the same font.  All processes attached to a store must
+   *   use the same library configuration (LCD filter, hinting engines,
+   *   etc.), since they exchange rendered bitmaps.  Faces with modified
+   *   variation coordinates are not shared.
+   *
+   *   The shared memory object persists until it is removed with
+   *   `shm_unlink`.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_SharedCache_Open( FT_TS_Library     library,
+                        const char*       name,
+                        FT_TS_ULong       size,
+                        FTC_SharedCache  *ashared );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_SharedCache_Close
+   *
+   * @description:
+   *   Detach from a shared bitmap store.
+   *
+   * @input:
+   *   shared ::
+   *     A handle to the store.
+   *
+   * @note:
+   *   Bitmaps returned by an @FTC_SBitCache attached to the store point
+   *   into it; the store must thus be closed only after the cache manager
+   *   has been destroyed.
+   */
+  FT_TS_EXPORT( void )
+  FTC_SharedCache_Close( FTC_SharedCache  shared );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_SBitCache_SetShared
+   *
+   * @description:
+   *   Attach a shared bitmap store to an sbit cache.  Glyphs missing from
+   *   the cache are then looked up in the store before rendering them,
+   *   and newly rendered glyphs are added to it.
+   *
+   * @input:
+   *   cache ::
+   *     A handle to the sbit cache.
+   *
+   *   shared ::
+   *     A handle to the store.  Use `NULL` to detach; bitmaps already
+   *     taken from the store stay valid.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Bitmaps taken from the store don't count against the `max_bytes`
+   *   limit of the cache manager, and their `buffer` field must not be
+   *   modified.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_SBitCache_SetShared( FTC_SBitCache    cache,
+                           FTC_SharedCache  shared );
+
+  /* */
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                    SIGNED DISTANCE FIELD CACHE                *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_SDFTypeRec
+   *
+   * @description:
+   *   A structure used to model the type of distance fields in an SDF
+   *   cache.
+   *
+   * @fields:
+   *   face_id ::
+   *     The face ID.
+   *
+   *   width ::
+   *     The width in pixels.
+   *
+   *   height ::
+   *     The height in pixels.
+   *
+   *   flags ::
+   *     The load flags, as in @FT_TS_Load_Glyph.
+   *
+   *   spread ::
+   *     The spread of the distance field in pixels, as with the `spread`
+   *     property of the 'sdf' and 'bsdf' modules.  The distance field is
+   *     padded by this value on all sides.
+   *
+   *   from_bitmap ::
+   *     If false, the distance field is computed from the glyph's outline
+   *     by the 'sdf' module.  If true, the glyph is loaded as a bitmap
+   *     (an embedded one if available, otherwise the rendered outline),
+   *     which is then converted by the 'bsdf' module.
+   */
+  typedef struct  FTC_SDFTypeRec_
+  {
+    FTC_FaceID   face_id;
+    FT_TS_UInt   width;
+    FT_TS_UInt   height;
+    FT_TS_Int32  flags;
+    FT_TS_UInt   spread;
+    FT_TS_Bool   from_bitmap;
+
+  } FTC_SDFTypeRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_SDFType
+   *
+   * @description:
+   *   A handle to an @FTC_SDFTypeRec structure.
+   */
+  typedef struct FTC_SDFTypeRec_*  FTC_SDFType;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_SDF
+   *
+   * @description:
+   *   A handle to a distance field descriptor.  See the @FTC_SDFRec
+   *   structure for details.
+   */
+  typedef struct FTC_SDFRec_*  FTC_SDF;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_SDFRec
+   *
+   * @description:
+   *   A structure used to describe the signed distance field of a glyph.
+   *
+   * @fields:
+   *   width ::
+   *     The width of the distance field in pixels, including the padding.
+   *
+   *   rows ::
+   *     The height of the distance field in pixels, including the padding.
+   *
+   *   left ::
+   *     The horizontal distance from the pen position to the left border
+   *     of the distance field.
+   *
+   *   top ::
+   *     The vertical distance from the pen position (on the baseline) to
+   *     the upper border of the distance field.  The distance is positive
+   *     for upwards y~coordinates.
+   *
+   *   xadvance ::
+   *     The horizontal advance width in 26.6 pixel format.
+   *
+   *   yadvance ::
+   *     The vertical advance height in 26.6 pixel format.
+   *
+   *   spread ::
+   *     The spread the distance field was computed with.
+   *
+   *   buffer ::
+   *     The distances, as `width` times `rows` signed bytes without
+   *     padding between rows, top row first.  A value~v stands for a
+   *     distance of v/128 times `spread` pixels to the nearest contour;
+   *     it is positive inside of contours unless the `flip_sign` property
+   *     of the rendering module is set.  `NULL` for glyphs without
+   *     contours.
+   *
+   * @note:
+   *   All values refer to the pixel size the distance field was computed
+   *   for.  To draw the glyph at another size, scale them by the ratio of
+   *   the two sizes; the distances scale accordingly.
+   */
+  typedef struct  FTC_SDFRec_
+  {
+    FT_TS_UInt   width;
+    FT_TS_UInt   rows;
+    FT_TS_Int    left;
+    FT_TS_Int    top;
+
+    FT_TS_Pos    xadvance;
+    FT_TS_Pos    yadvance;
+    FT_TS_UInt   spread;
+
+    FT_TS_Char*  buffer;
+
+  } FTC_SDFRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_SDFCache
+   *
+   * @description:
+   *   A handle to a signed distance field cache.  Every node holds the
+   *   distance field of one glyph, and its weight is the size of the
+   *   field; fields of the same glyph with different spreads or sources
+   *   are cached independently.
+   */
+  typedef struct FTC_SDFCacheRec_*  FTC_SDFCache;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_SDFCache_New
+   *
+   * @description:
+   *   Create a new cache to store signed distance fields.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the source cache manager.
+   *
+   * @output:
+   *   acache ::
+   *     A handle to the new SDF cache.  `NULL` in case of error.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_SDFCache_New( FTC_Manager    manager,
+                    FTC_SDFCache  *acache );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_SDFCache_Lookup
+   *
+   * @description:
+   *   Look up the signed distance field of a glyph in an SDF cache,
+   *   computing it if necessary.
+   *
+   * @input:
+   *   cache ::
+   *     A handle to the source SDF cache.
+   *
+   *   type ::
+   *     A pointer to the distance field type descriptor.
+   *
+   *   gindex ::
+   *     The glyph index.
+   *
+   * @output:
+   *   asdf ::
+   *     A handle to the distance field descriptor.
+   *
+   *   anode ::
+   *     Used to return the address of the corresponding cache node after
+   *     incrementing its reference count (see note below).
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The 'sdf' or 'bsdf' module must be part of the library.  Its
+   *   `spread` property is set to the value of `type` while rendering and
+   *   restored afterwards; all other properties of the module, like
+   *   `flip_sign`, apply as they are set when the glyph gets rendered.
+   *
+   *   The descriptor and its buffer are owned by the cache and should
+   *   never be freed by the application.  They might as well disappear
+   *   from memory on the next cache lookup, so don't treat them as
+   *   persistent data.
+   *
+   *   If `anode` is _not_ `NULL`, it receives the address of the cache node
+   *   containing the distance field, after increasing its reference count.
+   *   This ensures that the node will always be kept in the cache until
+   *   you call @FTC_Node_Unref to 'release' it.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_SDFCache_Lookup( FTC_SDFCache  cache,
+                       FTC_SDFType   type,
+                       FT_TS_UInt    gindex,
+                       FTC_SDF      *asdf,
+                       FTC_Node     *anode );
+
+  /* */
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                      STROKED GLYPH CACHE                      *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FTC_StrokeTypeRec
+   *
+   * @description:
+   *   A structure used to model the type of glyphs in a stroke cache.
+   *
+   * @fields:
+   *   face_id ::
+   *     The face ID.
+   *
+   *   width ::
+   *     The width in pixels.
+   *
+   *   height ::
+   *     The height in pixels.
+   *
+   *   flags ::
+   *     The load flags, as in @FT_TS_Load_Glyph.  If @FT_TS_LOAD_RENDER is
+   *     set, the stroked outline is converted to a bitmap, using the
+   *     render mode given by the @FT_TS_LOAD_TARGET_XXX value.
+   *
+   *   radius ::
+   *     The border radius, in 26.6 pixels, as with @FT_TS_Stroker_Set.
+   *
+   *   line_cap ::
+   *     The line cap style.
+   *
+   *   line_join ::
+   *     The line join style.
+   *
+   *   miter_limit ::
+   *     The miter limit for the miter join styles, as a 16.16 value.
+   *     Ignored for other join styles.
+   */
+  typedef struct  FTC_StrokeTypeRec_
+  {
+    FTC_FaceID              face_id;
+    FT_TS_UInt              width;
+    FT_TS_UInt              height;
+    FT_TS_Int32             flags;
+
+    FT_TS_Fixed             radius;
+    FT_TS_Stroker_LineCap   line_cap;
+    FT_TS_Stroker_LineJoin  line_join;
+    FT_TS_Fixed             miter_limit;
+
+  } FTC_StrokeTypeRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_StrokeType
+   *
+   * @description:
+   *   A handle to an @FTC_StrokeTypeRec structure.
+   */
+  typedef struct FTC_StrokeTypeRec_*  FTC_StrokeType;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FTC_StrokeCache
+   *
+   * @description:
+   *   A handle to a stroked glyph cache.  It holds outline glyphs stroked
+   *   with @FT_TS_Glyph_Stroke parameters, or their bitmaps.  The cache
+   *   owns one @FT_TS_Stroker, which it reuses for all glyphs.
+   */
+  typedef struct FTC_StrokeCacheRec_*  FTC_StrokeCache;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_StrokeCache_New
+   *
+   * @description:
+   *   Create a new cache to store stroked glyphs.
+   *
+   * @input:
+   *   manager ::
+   *     A handle to the source cache manager.
+   *
+   * @output:
+   *   acache ::
+   *     A handle to the new stroke cache.  `NULL` in case of error.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_StrokeCache_New( FTC_Manager       manager,
+                       FTC_StrokeCache  *acache );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FTC_StrokeCache_Lookup
+   *
+   * @description:
+   *   Retrieve a stroked glyph from a stroke cache, stroking (and
+   *   rendering) it if necessary.
+   *
+   * @input:
+   *   cache ::
+   *     A handle to the source stroke cache.
+   *
+   *   type ::
+   *     A pointer to the stroked glyph type descriptor.
+   *
+   *   gindex ::
+   *     The glyph index.
+   *
+   * @output:
+   *   aglyph ::
+   *     The corresponding @FT_TS_Glyph object, an @FT_TS_OutlineGlyph or
+   *     an @FT_TS_BitmapGlyph.  0~in case of failure.
+   *
+   *   anode ::
+   *     Used to return the address of the corresponding cache node after
+   *     incrementing its reference count (see note below).
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The glyph is loaded as an outline, even if the face has embedded
+   *   bitmaps; the result is the same as that of @FT_TS_Glyph_Stroke.
+   *   Its advance is not changed by the stroke.
+   *
+   *   The returned glyph is owned and managed by the cache.  Never try to
+   *   transform or discard it manually!  You can however create a copy
+   *   with @FT_TS_Glyph_Copy and modify the new one.
+   *
+   *   If `anode` is _not_ `NULL`, it receives the address of the cache node
+   *   containing the glyph, after increasing its reference count.  This
+   *   ensures that the node (as well as the @FT_TS_Glyph) will always be
+   *   kept in the cache until you call @FTC_Node_Unref to 'release' it.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FTC_StrokeCache_Lookup( FTC_StrokeCache  cache,
+                          FTC_StrokeType   type,
+                          FT_TS_UInt       gindex,
+                          FT_TS_Glyph     *aglyph,
+                          FTC_Node        *anode );
+
   /* */
 
 
@@ -121,6 +121,7 @@
    *   bitmap_handling
    *   raster
    *   glyph_stroker
+   *   canvas_rendering
    *   system_interface
    *   module_management
    *   gzip
@@ -214,9 +214,9 @@ FT_TS_BEGIN_HEADER
    *   itself, it is possible to control its behaviour with @FT_TS_Property_Set
    *   and @FT_TS_Property_Get.
    *
-   *   The TrueType driver's module name is 'truetype'; a single property
-   *   @interpreter-version is available, as documented in the @properties
-   *   section.
+   *   The TrueType driver's module name is 'truetype'; the properties
+   *   @interpreter-version and @sbit-atlas-limit are available, as
+   *   documented in the @properties section.
    *
    *   To help understand the differences between interpreter versions, we
    *   introduce a list of definitions, kindly provided by Greg Hitchcock.
@@ -821,6 +821,48 @@ FT_TS_BEGIN_HEADER
    */
 
 
+  /**************************************************************************
+   *
+   * @property:
+   *   sbit-atlas-limit
+   *
+   * @description:
+   *   Embedded bitmaps in 'EBLC' and 'EBDT' tables (as used by many CJK
+   *   fonts for small sizes) are normally located and decoded anew for
+   *   every glyph load.  If this property is set to a non-zero value, the
+   *   TrueType driver instead decodes a whole strike at once into a
+   *   contiguous atlas with uniformly pitched rows, together with a table
+   *   of glyph metrics; later loads of glyphs from that strike just copy
+   *   the rows from the atlas.
+   *
+   *   The value is an `FT_TS_ULong` giving the maximum number of bytes a
+   *   face may use for atlases.  Strikes that don't fit are handled as
+   *   usual.  The default is~0, disabling atlases.
+   *
+   * @note:
+   *   This property can be used with @FT_TS_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using a decimal number of bytes).
+   *
+   *   An atlas is built when a strike is used for the 16th time; it stays
+   *   allocated until the face is destroyed.  When using the cache
+   *   sub-system, the total atlas memory is thus bounded by this value
+   *   multiplied by the `max_faces` argument of @FTC_Manager_New.
+   *
+   *   Color bitmaps ('CBLC' and 'sbix' tables) are not affected.
+   *
+   * @example:
+   *   ```
+   *     FT_TS_ULong  limit = 4 * 1024 * 1024;
+   *
+   *
+   *     FT_TS_Property_Set( library, "truetype",
+   *                               "sbit-atlas-limit", &limit );
+   *   ```
+   */
+
+
   /**************************************************************************
    *
    * @property:
@@ -855,6 +897,174 @@ FT_TS_BEGIN_HEADER
    */
 
 
+  /**************************************************************************
+   *
+   * @property:
+   *   raster-pool-limit
+   *
+   * @description:
+   *   The anti-aliasing rasterizer of the 'smooth' renderer collects cells
+   *   in a pool of `FT_TS_RENDER_POOL_SIZE` bytes.  If a glyph needs more
+   *   cells, it is rendered in several horizontal bands, decomposing its
+   *   outline again for each band.  To avoid this for large glyphs, the
+   *   renderer then allocates a larger pool, doubling its size as needed,
+   *   and frees it after the glyph.
+   *
+   *   This property gives the maximum size of that pool as an
+   *   `FT_TS_ULong` number of bytes.  The default is 64 times
+   *   `FT_TS_RENDER_POOL_SIZE` (about 1MB); a value of~0 disables
+   *   growing.  Use @raster-stats to see whether a different value helps.
+   *
+   * @note:
+   *   This property can be used with @FT_TS_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using a decimal number of bytes).
+   *
+   * @example:
+   *   ```
+   *     FT_TS_ULong  limit = 4 * 1024 * 1024;
+   *
+   *
+   *     FT_TS_Property_Set( library, "smooth",
+   *                               "raster-pool-limit", &limit );
+   *   ```
+   */
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   raster-stats
+   *
+   * @description:
+   *   Retrieve statistics of the 'smooth' renderer's cell pool as an
+   *   @FT_TS_Prop_RasterStats structure, see @raster-pool-limit.
+   *
+   *   Setting this property (to any value) resets the counters.
+   *
+   * @note:
+   *   The counters are updated with atomic operations if the compiler
+   *   provides them.  Otherwise, the values are only approximate while
+   *   glyphs are rendered from several threads at the same time.
+   *
+   * @example:
+   *   ```
+   *     FT_TS_Prop_RasterStats  stats;
+   *
+   *
+   *     FT_TS_Property_Get( library, "smooth",
+   *                               "raster-stats", &stats );
+   *   ```
+   */
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_TS_Prop_RasterStats
+   *
+   * @description:
+   *   The data returned by the @raster-stats property.
+   *
+   * @fields:
+   *   band_restarts ::
+   *     The number of times a band had to be rendered again because the
+   *     cell pool overflowed, either with a larger pool or split in half.
+   *
+   *   pool_size ::
+   *     The size of the largest cell pool allocated for a glyph in bytes;
+   *     this is~0 as long as the pool on the stack has been sufficient.
+   *
+   *   pool_peak ::
+   *     The largest number of bytes of the pool used for a single band.
+   */
+  typedef struct  FT_TS_Prop_RasterStats_
+  {
+    FT_TS_ULong  band_restarts;
+    FT_TS_ULong  pool_size;
+    FT_TS_ULong  pool_peak;
+
+  } FT_TS_Prop_RasterStats;
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   lcd-single-pass
+   *
+   * @description:
+   *   By default, the 'smooth' renderer creates LCD bitmaps
+   *   (@FT_TS_RENDER_MODE_LCD and @FT_TS_RENDER_MODE_LCD_V) by rendering
+   *   the outline three times, shifted according to the subpixel geometry
+   *   set with @FT_TS_Library_SetLcdGeometry.  If this @FT_TS_Bool
+   *   property is set, the outline is rendered only once at three times
+   *   the resolution across the subpixel stripes instead, which is
+   *   faster.
+   *
+   *   This is only possible if the subpixels are shifted along the stripes
+   *   by multiples of a third of a pixel (as for the default RGB geometry
+   *   and its BGR counterpart); other geometries are still rendered in
+   *   three passes.  The coverage values can differ slightly from the
+   *   default method, since shifts of 21 or 22 units are treated as
+   *   exactly one third of a pixel.
+   *
+   * @note:
+   *   This property has no effect if FreeType is built with
+   *   `FT_TS_CONFIG_OPTION_SUBPIXEL_RENDERING`, which always renders LCD
+   *   bitmaps in a single pass.
+   *
+   *   This property can be used with @FT_TS_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using values 1 and 0 for 'on' and 'off', respectively).
+   *
+   * @example:
+   *   ```
+   *     FT_TS_Bool  single_pass = TRUE;
+   *
+   *
+   *     FT_TS_Property_Set( library, "smooth",
+   *                               "lcd-single-pass", &single_pass );
+   *   ```
+   */
+
+
+  /**************************************************************************
+   *
+   * @property:
+   *   gray-dither
+   *
+   * @description:
+   *   The 'smooth' renderer produces @FT_TS_RENDER_MODE_GRAY2 and
+   *   @FT_TS_RENDER_MODE_GRAY4 bitmaps by rounding every coverage value to
+   *   the nearest of the 4 or 16 available levels.  If this @FT_TS_Bool
+   *   property is set, a 4x4 ordered dither is applied instead, which
+   *   keeps the average gray level of larger areas at the cost of a
+   *   regular pattern.  The dither matrix is aligned with the pixel grid of
+   *   the glyph origin, so adjacent glyphs share the same pattern.
+   *
+   * @note:
+   *   Bitmaps cached with @FT_TS_LOAD_TARGET_GRAY2 or
+   *   @FT_TS_LOAD_TARGET_GRAY4 must be flushed after changing this
+   *   property.
+   *
+   *   This property can be used with @FT_TS_Property_Get also.
+   *
+   *   This property can be set via the `FREETYPE_PROPERTIES` environment
+   *   variable (using values 1 and 0 for 'on' and 'off', respectively).
+   *
+   * @example:
+   *   ```
+   *     FT_TS_Bool  dither = TRUE;
+   *
+   *
+   *     FT_TS_Property_Set( library, "smooth",
+   *                               "gray-dither", &dither );
+   *   ```
+   */
+
+
   /**************************************************************************
    *
    * @property:
@@ -661,6 +661,68 @@ FT_TS_BEGIN_HEADER
                       FT_TS_Bool           destroy );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Glyph_Render_Bitmap
+   *
+   * @description:
+   *   Render a glyph object into a new bitmap glyph object, leaving the
+   *   source glyph untouched.
+   *
+   * @input:
+   *   glyph ::
+   *     A handle to the source glyph.
+   *
+   *   render_mode ::
+   *     An enumeration that describes how the data is rendered.
+   *
+   *   matrix ::
+   *     A pointer to a 2x2 matrix applied to the glyph image before
+   *     rendering.  Can be~0 (if no transformation).
+   *
+   *   origin ::
+   *     A pointer to a vector used to translate the glyph image after the
+   *     transformation.  Can be~0 (if no translation).  The origin is
+   *     expressed in 26.6 pixels.
+   *
+   * @output:
+   *   abitmap ::
+   *     A handle to the new bitmap glyph.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The result is the same as copying `glyph` with @FT_TS_Glyph_Copy,
+   *   transforming the copy with @FT_TS_Glyph_Transform, and converting it
+   *   with @FT_TS_Glyph_To_Bitmap, destroying the copy.  The advance vector
+   *   is transformed with `matrix`, too.
+   *
+   *   If the library's current outline renderer is the 'smooth' module,
+   *   outline glyphs in @FT_TS_RENDER_MODE_NORMAL or
+   *   @FT_TS_RENDER_MODE_LIGHT are transformed on the fly while
+   *   rasterizing, without copying the outline.  Other renderers, glyphs,
+   *   and render modes take the above route.
+   *
+   *   The source glyph is only read, so glyphs kept in a cache can be
+   *   rendered from several threads at the same time, as with
+   *   @FT_TS_Render_Glyph for different faces of a library.  Besides the
+   *   bitmap, the rasterizer allocates scratch memory for glyphs too large
+   *   for its pool on the stack and for glyphs with overlapping contours
+   *   (see @FT_TS_OUTLINE_XXX).
+   *
+   *   Bitmap glyphs cannot be transformed; if `matrix` is set, an error is
+   *   returned for them.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Glyph_Render_Bitmap( FT_TS_Glyph          glyph,
+                          FT_TS_Render_Mode    render_mode,
+                          const FT_TS_Matrix*  matrix,
+                          const FT_TS_Vector*  origin,
+                          FT_TS_Glyph*         abitmap );
+
+
   /**************************************************************************
    *
    * @function:
@@ -145,12 +145,16 @@ FT_TS_BEGIN_HEADER
    *   FT_TS_PIXEL_MODE_GRAY2 ::
    *     A 2-bit per pixel bitmap, used to represent embedded anti-aliased
    *     bitmaps in font files according to the OpenType specification.  We
-   *     haven't found a single font using this format, however.
+   *     haven't found a single font using this format, however.  It is also
+   *     produced by @FT_TS_RENDER_MODE_GRAY2.  The leftmost pixel of a byte
+   *     is stored in its most significant bits.
    *
    *   FT_TS_PIXEL_MODE_GRAY4 ::
    *     A 4-bit per pixel bitmap, representing embedded anti-aliased bitmaps
    *     in font files according to the OpenType specification.  We haven't
-   *     found a single font using this format, however.
+   *     found a single font using this format, however.  It is also
+   *     produced by @FT_TS_RENDER_MODE_GRAY4, with the leftmost pixel of a
+   *     byte in its high nibble.
    *
    *   FT_TS_PIXEL_MODE_LCD ::
    *     An 8-bit bitmap, representing RGB or BGR decimated glyph images used
@@ -406,10 +410,13 @@ FT_TS_BEGIN_HEADER
    *
    *   FT_TS_OUTLINE_OVERLAP ::
    *     [Since 2.10.3] This flag indicates that this outline contains
-   *     overlapping contours and the anti-aliased renderer should perform
-   *     oversampling to mitigate possible artifacts.  This flag should _not_
-   *     be set for well designed glyphs without overlaps because it quadruples
-   *     the rendering time.
+   *     overlapping contours and the anti-aliased renderer should mitigate
+   *     possible artifacts.  With the non-zero winding rule, the parts of
+   *     contours inside other contours are left out while rendering; with
+   *     @FT_TS_OUTLINE_EVEN_ODD_FILL, the renderer performs 4x4
+   *     oversampling instead.  This flag should _not_ be set for well
+   *     designed glyphs without overlaps because it still makes rendering
+   *     slower.
    *
    *   FT_TS_OUTLINE_HIGH_PRECISION ::
    *     This flag indicates that the scan-line converter should try to
@@ -975,12 +982,30 @@ FT_TS_BEGIN_HEADER
    *     This flag is set to indicate that a signed distance field glyph
    *     image should be generated.  This is only used while rendering with
    *     the @FT_TS_RENDER_MODE_SDF render mode.
+   *
+   *   FT_TS_RASTER_FLAG_TRANSFORM ::
+   *     If set, each point of the source outline is transformed by the
+   *     `matrix` field (if not NULL) and translated by the `delta` field of
+   *     the @FT_TS_Raster_Params structure while it is read; the outline
+   *     itself is not modified.  Only the anti-aliasing rasterizer supports
+   *     this flag; others return `FT_TS_Err_Cannot_Render_Glyph`.
+   *
+   *   FT_TS_RASTER_FLAG_OVERLAP_STRICT ::
+   *     The anti-aliasing rasterizer removes the overlaps of outlines with
+   *     the @FT_TS_OUTLINE_OVERLAP flag and the non-zero winding rule if
+   *     their winding numbers don't change sign.  Otherwise, it renders
+   *     them like other outlines, so that pixels along the overlapping
+   *     edges get too much coverage.  If this flag is set, it returns
+   *     `FT_TS_Err_Cannot_Render_Glyph` for them instead, leaving the target
+   *     untouched; the caller can then oversample the outline.
    */
-#define FT_TS_RASTER_FLAG_DEFAULT  0x0
-#define FT_TS_RASTER_FLAG_AA       0x1
-#define FT_TS_RASTER_FLAG_DIRECT   0x2
-#define FT_TS_RASTER_FLAG_CLIP     0x4
-#define FT_TS_RASTER_FLAG_SDF      0x8
+#define FT_TS_RASTER_FLAG_DEFAULT         0x0
+#define FT_TS_RASTER_FLAG_AA              0x1
+#define FT_TS_RASTER_FLAG_DIRECT          0x2
+#define FT_TS_RASTER_FLAG_CLIP            0x4
+#define FT_TS_RASTER_FLAG_SDF             0x8
+#define FT_TS_RASTER_FLAG_TRANSFORM       0x10
+#define FT_TS_RASTER_FLAG_OVERLAP_STRICT  0x20
 
   /* these constants are deprecated; use the corresponding */
   /* `FT_TS_RASTER_FLAG_XXX` values instead                   */
@@ -1028,6 +1053,14 @@ FT_TS_BEGIN_HEADER
    *     An optional span clipping box expressed in _integer_ pixels
    *     (not in 26.6 fixed-point units).
    *
+   *   matrix ::
+   *     An optional 16.16 matrix applied to the source points; only used
+   *     with @FT_TS_RASTER_FLAG_TRANSFORM.
+   *
+   *   delta ::
+   *     A 26.6 translation applied to the source points after `matrix`;
+   *     only used with @FT_TS_RASTER_FLAG_TRANSFORM.
+   *
    * @note:
    *   The @FT_TS_RASTER_FLAG_AA bit flag must be set in the `flags` to
    *   generate an anti-aliased glyph bitmap, otherwise a monochrome bitmap
@@ -1057,6 +1090,8 @@ FT_TS_BEGIN_HEADER
     FT_TS_Raster_BitSet_Func   bit_set;      /* unused */
     void*                   user;
     FT_TS_BBox                 clip_box;
+    const struct FT_TS_Matrix_*  matrix;
+    FT_TS_Vector               delta;
 
   } FT_TS_Raster_Params;
 
@@ -316,6 +316,40 @@ FT_TS_BEGIN_HEADER
                               FT_TS_Long           scaling );
 
 
+  /*
+   * Scale `count' vectors by `x_scale' and `y_scale', respectively.  The
+   * result is identical to calling FT_TS_MulFix for every coordinate.
+   */
+  FT_TS_BASE( void )
+  FT_TS_Vectors_Scale( FT_TS_Vector*  vec,
+                    FT_TS_UInt     count,
+                    FT_TS_Fixed    x_scale,
+                    FT_TS_Fixed    y_scale );
+
+
+  /*
+   * Transform `count' vectors with `matrix' and translate them by `dx' and
+   * `dy'.  The result is identical to calling FT_TS_Vector_Transform for
+   * every vector before adding the offsets, but matrices without skew need
+   * fewer multiplications.
+   */
+  FT_TS_BASE( void )
+  FT_TS_Vectors_Transform( FT_TS_Vector*        vec,
+                        FT_TS_UInt           count,
+                        const FT_TS_Matrix*  matrix,
+                        FT_TS_Pos            dx,
+                        FT_TS_Pos            dy );
+
+
+  /*
+   * Compute the control box of `count' vectors; `count' must not be zero.
+   */
+  FT_TS_BASE( void )
+  FT_TS_Vectors_Get_CBox( const FT_TS_Vector*  vec,
+                       FT_TS_UInt           count,
+                       FT_TS_BBox*          cbox );
+
+
   /*
    * This function normalizes a vector and returns its original length.  The
    * normalized vector is a 16.16 fixed-point unit vector with length close
@@ -707,6 +707,14 @@ FT_TS_BEGIN_HEADER
                               FT_TS_Render_Mode    mode,
                               const FT_TS_Vector*  origin );
 
+  /* Ditto, for an outline with control box `acbox'; `slot->outline' is */
+  /* not used.                                                          */
+  FT_TS_BASE( FT_TS_Bool )
+  ft_glyphslot_preset_bitmap_cbox( FT_TS_GlyphSlot      slot,
+                                   FT_TS_Render_Mode    mode,
+                                   const FT_TS_BBox*    acbox,
+                                   const FT_TS_Vector*  origin );
+
   /* Allocate a new bitmap buffer in a glyph slot. */
   FT_TS_BASE( FT_TS_Error )
   ft_glyphslot_alloc_bitmap( FT_TS_GlyphSlot  slot,
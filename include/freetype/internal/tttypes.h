@@ -1118,6 +1118,10 @@ FT_TS_BEGIN_HEADER
   } TT_SbitTableType;
 
 
+  /* a fully decoded EBLC/EBDT strike; see `ttsbit.c' */
+  typedef struct TT_SBitAtlasRec_*  TT_SBitAtlas;
+
+
   /* OpenType 1.8 brings new tables for variation font support;  */
   /* to make the old MM and GX fonts still work we need to check */
   /* the presence (and validity) of the functionality provided   */
@@ -1410,6 +1414,15 @@ FT_TS_BEGIN_HEADER
    *     A mapping between the strike indices exposed by the API and the
    *     indices used in the font's sbit table.
    *
+   *   sbit_atlas_limit ::
+   *     The maximum memory used by `sbit_atlases`; 0 disables them.
+   *
+   *   sbit_atlas_size ::
+   *     The memory currently used by `sbit_atlases`.
+   *
+   *   sbit_atlases ::
+   *     An array of `sbit_num_strikes` decoded strikes, created on demand.
+   *
    *   cpal ::
    *     A pointer to data related to the 'CPAL' table.  `NULL` if the table
    *     is not available.
@@ -1612,6 +1625,9 @@ FT_TS_BEGIN_HEADER
     TT_SbitTableType      sbit_table_type;
     FT_TS_UInt               sbit_num_strikes;
     FT_TS_UInt*              sbit_strike_map;
+    FT_TS_ULong              sbit_atlas_limit;
+    FT_TS_ULong              sbit_atlas_size;
+    TT_SBitAtlas*         sbit_atlases;
 
     FT_TS_Byte*              kern_table;
     FT_TS_ULong              kern_table_size;
@@ -839,6 +839,404 @@
   }
 
 
+  /*
+   * The vector array functions below do the same arithmetic as
+   * `FT_TS_MulFix' and `FT_TS_Vector_Transform', point by point, but for a
+   * whole array at once.  With a 64-bit `FT_TS_Pos', a vector fits into a
+   * 128-bit register.
+   *
+   * - With SSE2, matrices whose entries are all zero or +/-1 (i.e., flips
+   *   and rotations by multiples of 90 degrees) are applied by swapping
+   *   and negating both coordinates at once.
+   *
+   * - `FT_TS_MulFix' needs a signed 32x32-bit multiplication and a 64-bit
+   *   comparison, which SSE2 lacks; with AVX2, two vectors are multiplied
+   *   at a time.  This reproduces the x86_64 version of `FT_TS_MulFix',
+   *   which truncates its arguments and result to 32 bits, and is thus
+   *   only used together with it.  Otherwise, the loops are scalar.
+   *
+   * - The control box is computed with AVX2 four vectors at a time.
+   *
+   * AVX2 is used unconditionally if the compiler targets it (e.g., with
+   * `-mavx2`).  Otherwise, GCC and clang compile the AVX2 functions
+   * anyway, and they are selected at run time if the CPU supports them,
+   * as for the LCD filter.
+   */
+#if ( defined( __SSE2__ ) || defined( __x86_64__ ) ) && \
+    FT_TS_SIZEOF_LONG == 8
+#  define FT_TS_VECTORS_SSE2  1
+#  include <emmintrin.h>
+#else
+#  define FT_TS_VECTORS_SSE2  0
+#endif
+
+#if FT_TS_VECTORS_SSE2 && defined( __AVX2__ )
+#  define FT_TS_VECTORS_AVX2       1
+#  define FT_TS_VECTORS_TARGET     /* empty */
+#  define FT_TS_VECTORS_USE_AVX2   1
+#elif FT_TS_VECTORS_SSE2 && defined( __x86_64__ )        && \
+      ( defined( __clang__ )                           || \
+        ( defined( __GNUC__ ) && __GNUC__ >= 5 )       )
+#  define FT_TS_VECTORS_AVX2       1
+#  define FT_TS_VECTORS_TARGET     __attribute__(( target( "avx2" ) ))
+#  define FT_TS_VECTORS_USE_AVX2   __builtin_cpu_supports( "avx2" )
+#else
+#  define FT_TS_VECTORS_AVX2  0
+#endif
+
+#if FT_TS_VECTORS_AVX2
+#  include <immintrin.h>
+#endif
+
+#if FT_TS_VECTORS_AVX2 && defined( FT_TS_MULFIX_ASSEMBLER )
+#  define FT_TS_VECTORS_AVX2_MULFIX  1
+#else
+#  define FT_TS_VECTORS_AVX2_MULFIX  0
+#endif
+
+
+#if FT_TS_VECTORS_AVX2_MULFIX
+
+  /* `FT_TS_MulFix' for four 64-bit lanes */
+  FT_TS_VECTORS_TARGET
+  static __m256i
+  ft_mulfix_avx2( __m256i  a,
+                  __m256i  b )
+  {
+    __m256i  ab = _mm256_mul_epi32( a, b );
+
+
+    ab = _mm256_add_epi64(
+           ab,
+           _mm256_add_epi64( _mm256_set1_epi64x( 0x8000 ),
+                             _mm256_cmpgt_epi64( _mm256_setzero_si256(),
+                                                 ab ) ) );
+    ab = _mm256_srli_epi64( ab, 16 );
+
+    /* sign-extend the lower 32 bits of each lane */
+    return _mm256_blend_epi32(
+             ab,
+             _mm256_srai_epi32( _mm256_shuffle_epi32( ab, 0xA0 ), 31 ),
+             0xAA );
+  }
+
+
+  /* Scale pairs of vectors up to `limit'; return the first vector left. */
+  FT_TS_VECTORS_TARGET
+  static FT_TS_Vector*
+  ft_vectors_scale_avx2( FT_TS_Vector*  vec,
+                         FT_TS_Vector*  limit,
+                         FT_TS_Fixed    x_scale,
+                         FT_TS_Fixed    y_scale )
+  {
+    __m256i  scale = _mm256_setr_epi64x( x_scale, y_scale,
+                                         x_scale, y_scale );
+
+
+    for ( ; vec + 2 <= limit; vec += 2 )
+      _mm256_storeu_si256(
+        (__m256i*)vec,
+        ft_mulfix_avx2( _mm256_loadu_si256( (__m256i*)vec ), scale ) );
+
+    return vec;
+  }
+
+
+  /* Transform pairs of vectors up to `limit'; return the first vector */
+  /* left.                                                             */
+  FT_TS_VECTORS_TARGET
+  static FT_TS_Vector*
+  ft_vectors_transform_avx2( FT_TS_Vector*        vec,
+                             FT_TS_Vector*        limit,
+                             const FT_TS_Matrix*  matrix,
+                             FT_TS_Pos            dx,
+                             FT_TS_Pos            dy )
+  {
+    __m256i  mx    = _mm256_setr_epi64x( matrix->xx, matrix->yx,
+                                         matrix->xx, matrix->yx );
+    __m256i  my    = _mm256_setr_epi64x( matrix->xy, matrix->yy,
+                                         matrix->xy, matrix->yy );
+    __m256i  delta = _mm256_setr_epi64x( dx, dy, dx, dy );
+
+
+    for ( ; vec + 2 <= limit; vec += 2 )
+    {
+      __m256i  v = _mm256_loadu_si256( (__m256i*)vec );
+
+
+      /* the shuffles duplicate the x and y coordinates, respectively */
+      v = _mm256_add_epi64(
+            _mm256_add_epi64(
+              ft_mulfix_avx2( _mm256_shuffle_epi32( v, 0x44 ), mx ),
+              ft_mulfix_avx2( _mm256_shuffle_epi32( v, 0xEE ), my ) ),
+            delta );
+      _mm256_storeu_si256( (__m256i*)vec, v );
+    }
+
+    return vec;
+  }
+
+#endif /* FT_TS_VECTORS_AVX2_MULFIX */
+
+
+#if FT_TS_VECTORS_AVX2
+
+  /* Extend `cbox' by the vectors from `vec' to `limit', except for up */
+  /* to three at the end; return the first vector left.               */
+  FT_TS_VECTORS_TARGET
+  static const FT_TS_Vector*
+  ft_vectors_cbox_avx2( const FT_TS_Vector*  vec,
+                        const FT_TS_Vector*  limit,
+                        FT_TS_BBox*          cbox )
+  {
+    __m256i  vmin, vmax, wmin, wmax;
+    __m128i  lo, hi, gt;
+
+
+    if ( vec + 2 > limit )
+      return vec;
+
+    vmin = _mm256_loadu_si256( (const __m256i*)vec );
+    vmax = vmin;
+    wmin = vmin;
+    wmax = vmin;
+
+    /* two accumulators shorten the dependency chains */
+    for ( vec += 2; vec + 4 <= limit; vec += 4 )
+    {
+      __m256i  v = _mm256_loadu_si256( (const __m256i*)vec );
+      __m256i  w = _mm256_loadu_si256( (const __m256i*)( vec + 2 ) );
+
+
+      vmin = _mm256_blendv_epi8( vmin, v, _mm256_cmpgt_epi64( vmin, v ) );
+      vmax = _mm256_blendv_epi8( vmax, v, _mm256_cmpgt_epi64( v, vmax ) );
+      wmin = _mm256_blendv_epi8( wmin, w, _mm256_cmpgt_epi64( wmin, w ) );
+      wmax = _mm256_blendv_epi8( wmax, w, _mm256_cmpgt_epi64( w, wmax ) );
+    }
+
+    vmin = _mm256_blendv_epi8( vmin, wmin, _mm256_cmpgt_epi64( vmin, wmin ) );
+    vmax = _mm256_blendv_epi8( vmax, wmax, _mm256_cmpgt_epi64( wmax, vmax ) );
+
+    /* reduce the two vectors of each accumulator */
+    lo = _mm256_castsi256_si128( vmin );
+    hi = _mm256_extracti128_si256( vmin, 1 );
+    gt = _mm_cmpgt_epi64( lo, hi );
+    lo = _mm_or_si128( _mm_and_si128( gt, hi ), _mm_andnot_si128( gt, lo ) );
+
+    if ( _mm_cvtsi128_si64( lo ) < cbox->xMin )
+      cbox->xMin = _mm_cvtsi128_si64( lo );
+    if ( _mm_cvtsi128_si64( _mm_unpackhi_epi64( lo, lo ) ) < cbox->yMin )
+      cbox->yMin = _mm_cvtsi128_si64( _mm_unpackhi_epi64( lo, lo ) );
+
+    lo = _mm256_castsi256_si128( vmax );
+    hi = _mm256_extracti128_si256( vmax, 1 );
+    gt = _mm_cmpgt_epi64( hi, lo );
+    lo = _mm_or_si128( _mm_and_si128( gt, hi ), _mm_andnot_si128( gt, lo ) );
+
+    if ( _mm_cvtsi128_si64( lo ) > cbox->xMax )
+      cbox->xMax = _mm_cvtsi128_si64( lo );
+    if ( _mm_cvtsi128_si64( _mm_unpackhi_epi64( lo, lo ) ) > cbox->yMax )
+      cbox->yMax = _mm_cvtsi128_si64( _mm_unpackhi_epi64( lo, lo ) );
+
+    return vec;
+  }
+
+#endif /* FT_TS_VECTORS_AVX2 */
+
+
+  /* documentation is in ftcalc.h */
+
+  FT_TS_BASE_DEF( void )
+  FT_TS_Vectors_Scale( FT_TS_Vector*  vec,
+                    FT_TS_UInt     count,
+                    FT_TS_Fixed    x_scale,
+                    FT_TS_Fixed    y_scale )
+  {
+    FT_TS_Vector*  limit = vec + count;
+
+
+#if FT_TS_VECTORS_AVX2_MULFIX
+    if ( FT_TS_VECTORS_USE_AVX2 )
+      vec = ft_vectors_scale_avx2( vec, limit, x_scale, y_scale );
+#endif
+
+    for ( ; vec < limit; vec++ )
+    {
+      vec->x = FT_TS_MulFix( vec->x, x_scale );
+      vec->y = FT_TS_MulFix( vec->y, y_scale );
+    }
+  }
+
+
+  /* documentation is in ftcalc.h */
+
+  FT_TS_BASE_DEF( void )
+  FT_TS_Vectors_Transform( FT_TS_Vector*        vec,
+                        FT_TS_UInt           count,
+                        const FT_TS_Matrix*  matrix,
+                        FT_TS_Pos            dx,
+                        FT_TS_Pos            dy )
+  {
+    FT_TS_Vector*  limit = vec + count;
+    FT_TS_Fixed    xx    = matrix->xx;
+    FT_TS_Fixed    xy    = matrix->xy;
+    FT_TS_Fixed    yx    = matrix->yx;
+    FT_TS_Fixed    yy    = matrix->yy;
+    FT_TS_Bool     swap  = 0;
+
+
+    if ( !xy && !yx )
+    {
+      /* scaling */
+      if ( ( xx != 0x10000L && xx != -0x10000L ) ||
+           ( yy != 0x10000L && yy != -0x10000L ) )
+      {
+        if ( !dx && !dy )
+        {
+          FT_TS_Vectors_Scale( vec, count, xx, yy );
+          return;
+        }
+
+        for ( ; vec < limit; vec++ )
+        {
+          vec->x = ADD_LONG( FT_TS_MulFix( vec->x, xx ), dx );
+          vec->y = ADD_LONG( FT_TS_MulFix( vec->y, yy ), dy );
+        }
+        return;
+      }
+
+      /* identity */
+      if ( xx > 0 && yy > 0 && !dx && !dy )
+        return;
+    }
+    else if ( !xx && !yy )
+    {
+      /* rotation by 90 or 270 degrees */
+      if ( ( xy != 0x10000L && xy != -0x10000L ) ||
+           ( yx != 0x10000L && yx != -0x10000L ) )
+      {
+        for ( ; vec < limit; vec++ )
+        {
+          FT_TS_Pos  x = vec->x;
+
+
+          vec->x = ADD_LONG( FT_TS_MulFix( vec->y, xy ), dx );
+          vec->y = ADD_LONG( FT_TS_MulFix( x, yx ), dy );
+        }
+        return;
+      }
+
+      swap = 1;
+      xx   = xy;
+      yy   = yx;
+    }
+    else
+    {
+#if FT_TS_VECTORS_AVX2_MULFIX
+      if ( FT_TS_VECTORS_USE_AVX2 )
+        vec = ft_vectors_transform_avx2( vec, limit, matrix, dx, dy );
+#endif
+
+      for ( ; vec < limit; vec++ )
+      {
+        FT_TS_Pos  xz = FT_TS_MulFix( vec->x, xx ) +
+                        FT_TS_MulFix( vec->y, xy );
+        FT_TS_Pos  yz = FT_TS_MulFix( vec->x, yx ) +
+                        FT_TS_MulFix( vec->y, yy );
+
+
+        vec->x = ADD_LONG( xz, dx );
+        vec->y = ADD_LONG( yz, dy );
+      }
+      return;
+    }
+
+    /* all remaining matrix entries are either zero or +/-1 */
+#if FT_TS_VECTORS_SSE2
+    {
+      __m128i  sign  = _mm_set_epi64x( yy < 0 ? -1 : 0, xx < 0 ? -1 : 0 );
+      __m128i  delta = _mm_set_epi64x( dy, dx );
+
+
+      for ( ; vec < limit; vec++ )
+      {
+        __m128i  v = _mm_loadu_si128( (__m128i*)vec );
+
+
+        if ( swap )
+          v = _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+
+        v = _mm_sub_epi64( _mm_xor_si128( v, sign ), sign );
+        _mm_storeu_si128( (__m128i*)vec, _mm_add_epi64( v, delta ) );
+      }
+    }
+#else
+    for ( ; vec < limit; vec++ )
+    {
+      FT_TS_Pos  x = swap ? vec->y : vec->x;
+      FT_TS_Pos  y = swap ? vec->x : vec->y;
+
+
+      vec->x = ADD_LONG( xx < 0 ? NEG_LONG( x ) : x, dx );
+      vec->y = ADD_LONG( yy < 0 ? NEG_LONG( y ) : y, dy );
+    }
+#endif
+  }
+
+
+  /* documentation is in ftcalc.h */
+
+  FT_TS_BASE_DEF( void )
+  FT_TS_Vectors_Get_CBox( const FT_TS_Vector*  vec,
+                       FT_TS_UInt           count,
+                       FT_TS_BBox*          cbox )
+  {
+    const FT_TS_Vector*  limit = vec + count;
+    FT_TS_Pos            xMin, yMin, xMax, yMax;
+
+
+    xMin = xMax = vec->x;
+    yMin = yMax = vec->y;
+    vec++;
+
+#if FT_TS_VECTORS_AVX2
+    if ( FT_TS_VECTORS_USE_AVX2 )
+    {
+      cbox->xMin = xMin;
+      cbox->xMax = xMax;
+      cbox->yMin = yMin;
+      cbox->yMax = yMax;
+
+      vec = ft_vectors_cbox_avx2( vec, limit, cbox );
+
+      xMin = cbox->xMin;
+      xMax = cbox->xMax;
+      yMin = cbox->yMin;
+      yMax = cbox->yMax;
+    }
+#endif
+
+    for ( ; vec < limit; vec++ )
+    {
+      FT_TS_Pos  x, y;
+
+
+      x = vec->x;
+      if ( x < xMin ) xMin = x;
+      if ( x > xMax ) xMax = x;
+
+      y = vec->y;
+      if ( y < yMin ) yMin = y;
+      if ( y > yMax ) yMax = y;
+    }
+
+    cbox->xMin = xMin;
+    cbox->xMax = xMax;
+    cbox->yMin = yMin;
+    cbox->yMax = yMax;
+  }
+
+
   /* documentation is in ftcalc.h */
 
   FT_TS_BASE_DEF( FT_TS_UInt32 )
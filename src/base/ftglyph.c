@@ -886,6 +886,203 @@
   }
 
 
+  /* Render `glyph' with the `smooth' raster, transforming its points  */
+  /* while they are read.  The result is identical to transforming and */
+  /* translating a copy of the outline, then calling `ft_smooth_render'. */
+  static FT_TS_Error
+  ft_outline_glyph_render( FT_TS_OutlineGlyph   glyph,
+                           FT_TS_Renderer       renderer,
+                           FT_TS_Render_Mode    render_mode,
+                           const FT_TS_Matrix*  matrix,
+                           const FT_TS_Vector*  origin,
+                           FT_TS_Glyph*         abitmap )
+  {
+    FT_TS_Library                library = FT_TS_GLYPH( glyph )->library;
+    FT_TS_Memory                 memory  = library->memory;
+    const FT_TS_Outline*         outline = &glyph->outline;
+    FT_TS_GlyphSlotRec           dummy;
+    FT_TS_GlyphSlot_InternalRec  dummy_internal;
+    FT_TS_Raster_Params          params;
+    FT_TS_BBox                   cbox;
+    FT_TS_Vector                 delta;
+    FT_TS_Glyph                  b;
+    FT_TS_BitmapGlyph            bitmap;
+    FT_TS_Bitmap*                target;
+    FT_TS_Error                  error;
+
+
+    delta.x = origin ? origin->x : 0;
+    delta.y = origin ? origin->y : 0;
+
+    /* control box of the transformed outline; the points are */
+    /* transformed in batches since the source is read-only    */
+    cbox.xMin = cbox.yMin = cbox.xMax = cbox.yMax = 0;
+
+    if ( outline->n_points > 0 && matrix )
+    {
+      FT_TS_Vector  vecs[64];
+      FT_TS_UInt    count = (FT_TS_UInt)outline->n_points;
+      FT_TS_UInt    i, n;
+
+
+      for ( i = 0; i < count; i += n )
+      {
+        FT_TS_BBox  box;
+
+
+        n = FT_TS_MIN( count - i, 64 );
+
+        FT_TS_ARRAY_COPY( vecs, outline->points + i, n );
+        FT_TS_Vectors_Transform( vecs, n, matrix, delta.x, delta.y );
+        FT_TS_Vectors_Get_CBox( vecs, n, &box );
+
+        if ( !i )
+          cbox = box;
+        else
+        {
+          cbox.xMin = FT_TS_MIN( cbox.xMin, box.xMin );
+          cbox.yMin = FT_TS_MIN( cbox.yMin, box.yMin );
+          cbox.xMax = FT_TS_MAX( cbox.xMax, box.xMax );
+          cbox.yMax = FT_TS_MAX( cbox.yMax, box.yMax );
+        }
+      }
+    }
+    else if ( outline->n_points > 0 )
+    {
+      FT_TS_Outline_Get_CBox( outline, &cbox );
+
+      cbox.xMin += delta.x;
+      cbox.yMin += delta.y;
+      cbox.xMax += delta.x;
+      cbox.yMax += delta.y;
+    }
+
+    /* the bitmap geometry is computed as for a glyph slot */
+    FT_TS_ZERO( &dummy );
+    FT_TS_ZERO( &dummy_internal );
+    dummy.internal = &dummy_internal;
+    dummy.library  = library;
+    dummy.format   = FT_TS_GLYPH_FORMAT_OUTLINE;
+
+    if ( ft_glyphslot_preset_bitmap_cbox( &dummy, render_mode, &cbox, NULL ) )
+      return FT_TS_THROW( Raster_Overflow );
+
+    error = ft_new_glyph( library, &ft_bitmap_glyph_class, &b );
+    if ( error )
+      return error;
+    bitmap = (FT_TS_BitmapGlyph)b;
+
+    bitmap->left   = dummy.bitmap_left;
+    bitmap->top    = dummy.bitmap_top;
+    bitmap->bitmap = dummy.bitmap;
+    target         = &bitmap->bitmap;
+
+    if ( target->rows && target->pitch )
+    {
+      if ( FT_TS_ALLOC_MULT( target->buffer, target->rows, target->pitch ) )
+        goto Fail;
+
+      delta.x += 64 * -dummy.bitmap_left;
+      delta.y += 64 * -dummy.bitmap_top + 64 * (FT_TS_Int)target->rows;
+
+      params.target = target;
+      params.source = outline;
+      params.flags  = FT_TS_RASTER_FLAG_AA               |
+                      FT_TS_RASTER_FLAG_TRANSFORM        |
+                      FT_TS_RASTER_FLAG_OVERLAP_STRICT;
+      params.matrix = matrix;
+      params.delta  = delta;
+
+      error = renderer->raster_render( renderer->raster, &params );
+      if ( error )
+        goto Fail;
+    }
+
+    b->advance = FT_TS_GLYPH( glyph )->advance;
+    if ( matrix )
+      FT_TS_Vector_Transform( &b->advance, matrix );
+
+    *abitmap = b;
+    return FT_TS_Err_Ok;
+
+  Fail:
+    FT_TS_Done_Glyph( b );
+    return error;
+  }
+
+
+  /* documentation is in ftglyph.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Glyph_Render_Bitmap( FT_TS_Glyph          glyph,
+                          FT_TS_Render_Mode    render_mode,
+                          const FT_TS_Matrix*  matrix,
+                          const FT_TS_Vector*  origin,
+                          FT_TS_Glyph*         abitmap )
+  {
+    FT_TS_Error     error;
+    FT_TS_Renderer  renderer;
+    FT_TS_Glyph     copy;
+
+
+    if ( !abitmap )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *abitmap = NULL;
+
+    if ( !glyph || !glyph->library || !glyph->clazz )
+      return FT_TS_THROW( Invalid_Argument );
+
+    /* The direct path hands the outline with `FT_TS_RASTER_FLAG_TRANSFORM' */
+    /* to the raster of the current outline renderer, and only the gray    */
+    /* raster of the 'smooth' module supports this flag.  Its module name  */
+    /* is therefore checked; other renderers (e.g., one that replaces      */
+    /* 'smooth' via `FT_TS_Set_Renderer') take the route below.            */
+    renderer = glyph->library->cur_renderer;
+
+    if ( glyph->clazz == &ft_outline_glyph_class             &&
+         ( render_mode == FT_TS_RENDER_MODE_NORMAL ||
+           render_mode == FT_TS_RENDER_MODE_LIGHT  )          &&
+         renderer                                            &&
+         !ft_strcmp( renderer->root.clazz->module_name, "smooth" ) )
+    {
+      FT_TS_OutlineGlyph  outline_glyph = (FT_TS_OutlineGlyph)glyph;
+      FT_TS_Int           flags         = outline_glyph->outline.flags;
+
+
+      /* even-odd overlaps are oversampled by the renderer itself; */
+      /* others fail here if the raster cannot remove them exactly */
+      if ( !( ( flags & FT_TS_OUTLINE_OVERLAP )       &&
+              ( flags & FT_TS_OUTLINE_EVEN_ODD_FILL ) ) )
+      {
+        error = ft_outline_glyph_render( outline_glyph, renderer,
+                                         render_mode, matrix, origin,
+                                         abitmap );
+        if ( FT_TS_ERR_NEQ( error, Cannot_Render_Glyph ) )
+          return error;
+      }
+    }
+
+    /* everything else is rendered from a transformed copy */
+    error = FT_TS_Glyph_Copy( glyph, &copy );
+    if ( error )
+      return error;
+
+    if ( matrix )
+      error = FT_TS_Glyph_Transform( copy, matrix, NULL );
+
+    if ( !error )
+      error = FT_TS_Glyph_To_Bitmap( &copy, render_mode, origin, 1 );
+
+    if ( error )
+      FT_TS_Done_Glyph( copy );
+    else
+      *abitmap = copy;
+
+    return error;
+  }
+
+
   /* documentation is in ftglyph.h */
 
   FT_TS_EXPORT_DEF( void )
@@ -30,6 +30,35 @@
 
 #define FT_TS_SHIFTCLAMP( x )  ( x >>= 8, (FT_TS_Byte)( x > 255 ? 255 : x ) )
 
+  /*
+   * The FIR filter can process a whole block of pixels at once with SSE2
+   * instructions, which are always available on x86_64, or with AVX2,
+   * which handles blocks twice as large.  AVX2 is used unconditionally if
+   * the compiler targets it (e.g., with `-mavx2`).  Otherwise, GCC and
+   * clang compile both versions, and AVX2 is selected at run time if the
+   * CPU supports it; with other compilers, AVX2 needs the corresponding
+   * compiler option (e.g., `/arch:AVX2`).
+   */
+#if defined( __AVX2__ )
+#  define FT_TS_LCD_FIR_SSE2  0
+#  define FT_TS_LCD_FIR_AVX2  1
+#elif defined( __SSE2__ )                                      && \
+      ( defined( __x86_64__ ) || defined( __i386__ ) )          && \
+      ( defined( __clang__ )                                 || \
+        ( defined( __GNUC__ ) && __GNUC__ >= 5 )             )
+#  define FT_TS_LCD_FIR_SSE2  1
+#  define FT_TS_LCD_FIR_AVX2  1
+#elif defined( __SSE2__ )                          || \
+      defined( __x86_64__ )                        || \
+      defined( _M_AMD64 )                          || \
+      ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  define FT_TS_LCD_FIR_SSE2  1
+#  define FT_TS_LCD_FIR_AVX2  0
+#else
+#  define FT_TS_LCD_FIR_SSE2  0
+#  define FT_TS_LCD_FIR_AVX2  0
+#endif
+
 
   /* add padding according to filter weights */
   FT_TS_BASE_DEF( void )
@@ -73,6 +102,21 @@
   }
 
 
+#if FT_TS_LCD_FIR_SSE2
+#  include <emmintrin.h>
+#  define FT_TS_LCD_AVX2  0
+#  include "ftlcdsimd.h"
+#  undef FT_TS_LCD_AVX2
+#endif
+
+#if FT_TS_LCD_FIR_AVX2
+#  include <immintrin.h>
+#  define FT_TS_LCD_AVX2  1
+#  include "ftlcdsimd.h"
+#  undef FT_TS_LCD_AVX2
+#endif
+
+
   /* FIR filter used by the default and light filters */
   FT_TS_BASE_DEF( void )
   ft_lcd_filter_fir( FT_TS_Bitmap*           bitmap,
@@ -89,6 +133,21 @@
     if ( pitch > 0 && height > 0 )
       origin += pitch * (FT_TS_Int)( height - 1 );
 
+#if FT_TS_LCD_FIR_SSE2 && FT_TS_LCD_FIR_AVX2
+    if ( __builtin_cpu_supports( "avx2" ) )
+      ft_lcd_filter_fir_simd_avx2( &origin, &width, &height,
+                                   pitch, mode, weights );
+    else
+      ft_lcd_filter_fir_simd_sse2( &origin, &width, &height,
+                                   pitch, mode, weights );
+#elif FT_TS_LCD_FIR_AVX2
+    ft_lcd_filter_fir_simd_avx2( &origin, &width, &height,
+                                 pitch, mode, weights );
+#elif FT_TS_LCD_FIR_SSE2
+    ft_lcd_filter_fir_simd_sse2( &origin, &width, &height,
+                                 pitch, mode, weights );
+#endif
+
     /* horizontal in-place FIR filter */
     if ( mode == FT_TS_PIXEL_MODE_LCD && width >= 2 )
     {
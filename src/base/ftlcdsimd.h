@@ -0,0 +1,311 @@
+/****************************************************************************
+ *
+ * ftlcdsimd.h
+ *
+ *   Vector code for the FIR filter of `ftlcdfil.c' (body).
+ *
+ * Copyright (C) 2006-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+  /*
+   * This file is included by `ftlcdfil.c' once for every instruction set
+   * the filter is compiled for, with `FT_TS_LCD_AVX2' set to 1 for AVX2
+   * and to 0 for SSE2.  The functions get the suffix `_avx2' or `_sse2',
+   * and `FT_TS_LCD_TARGET' enables AVX2 for the former if the compiler
+   * does not already target it.
+   */
+
+
+  /*
+   * Every filtered pixel is
+   *
+   *   out[i] = ( w[0] * in[i + 2] + w[1] * in[i + 1] + w[2] * in[i] +
+   *              w[3] * in[i - 1] + w[4] * in[i - 2]                 ) >> 8
+   *
+   * clamped to 255, both for rows (LCD) and for columns (LCD_V).  The sum
+   * can exceed 16 bits, so the products are formed with `pmaddwd', which
+   * multiplies pairs of interleaved 16-bit pixels with a pair of weights
+   * and adds them into 32-bit lanes; pixels outside of the bitmap are
+   * zero.  The results are identical to the scalar code.
+   */
+
+#if FT_TS_LCD_AVX2
+
+#  define FT_TS_LCD_BLOCK  32
+#  define FT_TS_LcdVec     __m256i
+
+#  ifdef __AVX2__
+#    define FT_TS_LCD_TARGET  /* empty */
+#  else
+#    define FT_TS_LCD_TARGET  __attribute__(( target( "avx2" ) ))
+#  endif
+
+#  define FT_TS_LCD_NAME( x )  x ## _avx2
+
+#  define LCD_LOAD( p )        _mm256_loadu_si256( (const __m256i*)(p) )
+#  define LCD_STORE( p, v )    _mm256_storeu_si256( (__m256i*)(p), v )
+#  define LCD_ZERO()           _mm256_setzero_si256()
+#  define LCD_SET1( x )        _mm256_set1_epi32( x )
+#  define LCD_UNPACKLO( a, b )  _mm256_unpacklo_epi8( a, b )
+#  define LCD_UNPACKHI( a, b )  _mm256_unpackhi_epi8( a, b )
+#  define LCD_MADD( a, b )     _mm256_madd_epi16( a, b )
+#  define LCD_ADD( a, b )      _mm256_add_epi32( a, b )
+#  define LCD_SHIFT( a )       _mm256_srli_epi32( a, 8 )
+#  define LCD_PACK32( a, b )   _mm256_packs_epi32( a, b )
+#  define LCD_PACK16( a, b )   _mm256_packus_epi16( a, b )
+
+#else /* !FT_TS_LCD_AVX2 */
+
+#  define FT_TS_LCD_BLOCK  16
+#  define FT_TS_LcdVec     __m128i
+
+#  define FT_TS_LCD_TARGET  /* empty */
+
+#  define FT_TS_LCD_NAME( x )  x ## _sse2
+
+#  define LCD_LOAD( p )        _mm_loadu_si128( (const __m128i*)(p) )
+#  define LCD_STORE( p, v )    _mm_storeu_si128( (__m128i*)(p), v )
+#  define LCD_ZERO()           _mm_setzero_si128()
+#  define LCD_SET1( x )        _mm_set1_epi32( x )
+#  define LCD_UNPACKLO( a, b )  _mm_unpacklo_epi8( a, b )
+#  define LCD_UNPACKHI( a, b )  _mm_unpackhi_epi8( a, b )
+#  define LCD_MADD( a, b )     _mm_madd_epi16( a, b )
+#  define LCD_ADD( a, b )      _mm_add_epi32( a, b )
+#  define LCD_SHIFT( a )       _mm_srli_epi32( a, 8 )
+#  define LCD_PACK32( a, b )   _mm_packs_epi32( a, b )
+#  define LCD_PACK16( a, b )   _mm_packus_epi16( a, b )
+
+#endif /* !FT_TS_LCD_AVX2 */
+
+#define ft_lcd_fir_madd            FT_TS_LCD_NAME( ft_lcd_fir_madd )
+#define ft_lcd_fir_block           FT_TS_LCD_NAME( ft_lcd_fir_block )
+#define ft_lcd_filter_fir_row      FT_TS_LCD_NAME( ft_lcd_filter_fir_row )
+#define ft_lcd_filter_fir_columns  FT_TS_LCD_NAME( ft_lcd_filter_fir_columns )
+#define ft_lcd_filter_fir_simd     FT_TS_LCD_NAME( ft_lcd_filter_fir_simd )
+
+
+  /* Add the products of the interleaved pixels of `a' and `b' with the */
+  /* weight pair `w' to the four partial sums in `s'.  All unpacking    */
+  /* works within 128-bit lanes, and so does the final packing, which   */
+  /* restores the pixel order.                                          */
+  FT_TS_LCD_TARGET
+  static void
+  ft_lcd_fir_madd( FT_TS_LcdVec   a,
+                   FT_TS_LcdVec   b,
+                   FT_TS_LcdVec   w,
+                   FT_TS_LcdVec*  s )
+  {
+    FT_TS_LcdVec  zero = LCD_ZERO();
+    FT_TS_LcdVec  lo   = LCD_UNPACKLO( a, b );
+    FT_TS_LcdVec  hi   = LCD_UNPACKHI( a, b );
+
+
+    s[0] = LCD_ADD( s[0], LCD_MADD( LCD_UNPACKLO( lo, zero ), w ) );
+    s[1] = LCD_ADD( s[1], LCD_MADD( LCD_UNPACKHI( lo, zero ), w ) );
+    s[2] = LCD_ADD( s[2], LCD_MADD( LCD_UNPACKLO( hi, zero ), w ) );
+    s[3] = LCD_ADD( s[3], LCD_MADD( LCD_UNPACKHI( hi, zero ), w ) );
+  }
+
+
+  /* Filter a block of pixels; `p0' holds the pixels at offset +2, */
+  /* `p4' those at offset -2.                                      */
+  FT_TS_LCD_TARGET
+  static FT_TS_LcdVec
+  ft_lcd_fir_block( FT_TS_LcdVec  p0,
+                    FT_TS_LcdVec  p1,
+                    FT_TS_LcdVec  p2,
+                    FT_TS_LcdVec  p3,
+                    FT_TS_LcdVec  p4,
+                    FT_TS_LcdVec  w01,
+                    FT_TS_LcdVec  w23,
+                    FT_TS_LcdVec  w4 )
+  {
+    FT_TS_LcdVec  s[4];
+
+
+    s[0] = s[1] = s[2] = s[3] = LCD_ZERO();
+
+    ft_lcd_fir_madd( p0, p1, w01, s );
+    ft_lcd_fir_madd( p2, p3, w23, s );
+    ft_lcd_fir_madd( p4, LCD_ZERO(), w4, s );
+
+    /* the shifted sums fit into 16 bits; */
+    /* saturation clamps them to 255      */
+    return LCD_PACK16( LCD_PACK32( LCD_SHIFT( s[0] ), LCD_SHIFT( s[1] ) ),
+                       LCD_PACK32( LCD_SHIFT( s[2] ), LCD_SHIFT( s[3] ) ) );
+  }
+
+
+  /* Filter a row of at least `FT_TS_LCD_BLOCK + 4' pixels in place.  The */
+  /* stores are delayed by one block, so that every block is loaded     */
+  /* before its left neighbour is overwritten; the few pixels at both   */
+  /* ends are filtered from saved copies afterwards.                    */
+  FT_TS_LCD_TARGET
+  static void
+  ft_lcd_filter_fir_row( FT_TS_Byte*             line,
+                         FT_TS_UInt              width,
+                         FT_TS_LcdFiveTapFilter  weights,
+                         FT_TS_LcdVec            w01,
+                         FT_TS_LcdVec            w23,
+                         FT_TS_LcdVec            w4 )
+  {
+    FT_TS_Byte    head[4];
+    FT_TS_Byte    tail[FT_TS_LCD_BLOCK + 4];
+    FT_TS_UInt    end = 2 + ( width - 4 ) / FT_TS_LCD_BLOCK * FT_TS_LCD_BLOCK;
+    FT_TS_UInt    xx, kk;
+    FT_TS_LcdVec  out = LCD_ZERO();
+
+
+    ft_memcpy( head, line, 4 );
+    ft_memcpy( tail, line + end - 2, width - end + 2 );
+
+    for ( xx = 2; xx < end; xx += FT_TS_LCD_BLOCK )
+    {
+      FT_TS_LcdVec  p0 = LCD_LOAD( line + xx + 2 );
+      FT_TS_LcdVec  p1 = LCD_LOAD( line + xx + 1 );
+      FT_TS_LcdVec  p2 = LCD_LOAD( line + xx );
+      FT_TS_LcdVec  p3 = LCD_LOAD( line + xx - 1 );
+      FT_TS_LcdVec  p4 = LCD_LOAD( line + xx - 2 );
+
+
+      if ( xx > 2 )
+        LCD_STORE( line + xx - FT_TS_LCD_BLOCK, out );
+
+      out = ft_lcd_fir_block( p0, p1, p2, p3, p4, w01, w23, w4 );
+    }
+
+    LCD_STORE( line + end - FT_TS_LCD_BLOCK, out );
+
+    for ( xx = 0; xx < 2; xx++ )
+    {
+      FT_TS_UInt  fir = 0;
+
+
+      for ( kk = 0; kk <= xx + 2; kk++ )
+        fir += weights[kk] * head[xx + 2 - kk];
+
+      line[xx] = FT_TS_SHIFTCLAMP( fir );
+    }
+
+    for ( xx = end; xx < width; xx++ )
+    {
+      FT_TS_UInt  fir = 0;
+
+
+      for ( kk = 0; kk < 5; kk++ )
+        if ( xx + 2 - kk < width )
+          fir += weights[kk] * tail[xx + 4 - kk - end];
+
+      line[xx] = FT_TS_SHIFTCLAMP( fir );
+    }
+  }
+
+
+  /* Filter a block of `FT_TS_LCD_BLOCK' columns in place, keeping the */
+  /* original values of the two rows above in registers.             */
+  FT_TS_LCD_TARGET
+  static void
+  ft_lcd_filter_fir_columns( FT_TS_Byte*   column,
+                             FT_TS_UInt    height,
+                             FT_TS_Int     pitch,
+                             FT_TS_LcdVec  w01,
+                             FT_TS_LcdVec  w23,
+                             FT_TS_LcdVec  w4 )
+  {
+    FT_TS_LcdVec  p1 = LCD_LOAD( column - pitch );
+    FT_TS_LcdVec  p2 = LCD_LOAD( column );
+    FT_TS_LcdVec  p3 = LCD_ZERO();
+    FT_TS_LcdVec  p4 = LCD_ZERO();
+    FT_TS_UInt    yy;
+
+
+    for ( yy = 0; yy < height; yy++, column -= pitch )
+    {
+      FT_TS_LcdVec  p0 = yy + 2 < height ? LCD_LOAD( column - 2 * pitch )
+                                         : LCD_ZERO();
+
+
+      LCD_STORE( column,
+                 ft_lcd_fir_block( p0, p1, p2, p3, p4, w01, w23, w4 ) );
+
+      p4 = p3;
+      p3 = p2;
+      p2 = p1;
+      p1 = p0;
+    }
+  }
+
+
+  /* Filter the rows (LCD) or blocks of columns (LCD_V) that are large */
+  /* enough for the vector code.  `*origin', `*width', and `*height'   */
+  /* are updated to what is left for the scalar code.                  */
+  FT_TS_LCD_TARGET
+  static void
+  ft_lcd_filter_fir_simd( FT_TS_Byte**            origin,
+                          FT_TS_UInt*             width,
+                          FT_TS_UInt*             height,
+                          FT_TS_Int               pitch,
+                          FT_TS_Byte              mode,
+                          FT_TS_LcdFiveTapFilter  weights )
+  {
+    FT_TS_LcdVec  w01 = LCD_SET1( (int)( weights[0] | weights[1] << 16 ) );
+    FT_TS_LcdVec  w23 = LCD_SET1( (int)( weights[2] | weights[3] << 16 ) );
+    FT_TS_LcdVec  w4  = LCD_SET1( (int)weights[4] );
+
+
+    /* rows that are too short are left to the scalar code */
+    if ( mode == FT_TS_PIXEL_MODE_LCD && *width >= FT_TS_LCD_BLOCK + 4 )
+    {
+      FT_TS_Byte*  line = *origin;
+
+
+      for ( ; *height > 0; (*height)--, line -= pitch )
+        ft_lcd_filter_fir_row( line, *width, weights, w01, w23, w4 );
+    }
+
+    /* the remaining columns are left to the scalar code */
+    else if ( mode == FT_TS_PIXEL_MODE_LCD_V && *height >= 2 )
+    {
+      for ( ; *width >= FT_TS_LCD_BLOCK; *width -= FT_TS_LCD_BLOCK )
+      {
+        ft_lcd_filter_fir_columns( *origin, *height, pitch, w01, w23, w4 );
+        *origin += FT_TS_LCD_BLOCK;
+      }
+    }
+  }
+
+
+#undef ft_lcd_fir_madd
+#undef ft_lcd_fir_block
+#undef ft_lcd_filter_fir_row
+#undef ft_lcd_filter_fir_columns
+#undef ft_lcd_filter_fir_simd
+
+#undef FT_TS_LCD_BLOCK
+#undef FT_TS_LcdVec
+#undef FT_TS_LCD_TARGET
+#undef FT_TS_LCD_NAME
+
+#undef LCD_LOAD
+#undef LCD_STORE
+#undef LCD_ZERO
+#undef LCD_SET1
+#undef LCD_UNPACKLO
+#undef LCD_UNPACKHI
+#undef LCD_MADD
+#undef LCD_ADD
+#undef LCD_SHIFT
+#undef LCD_PACK32
+#undef LCD_PACK16
+
+
+/* END */
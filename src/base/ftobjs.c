@@ -378,16 +378,7 @@
                               FT_TS_Render_Mode    mode,
                               const FT_TS_Vector*  origin )
   {
-    FT_TS_Outline*  outline = &slot->outline;
-    FT_TS_Bitmap*   bitmap  = &slot->bitmap;
-
-    FT_TS_Pixel_Mode  pixel_mode;
-
-    FT_TS_BBox  cbox, pbox;
-    FT_TS_Pos   x_shift = 0;
-    FT_TS_Pos   y_shift = 0;
-    FT_TS_Pos   x_left, y_top;
-    FT_TS_Pos   width, height, pitch;
+    FT_TS_BBox  cbox;
 
 
     if ( slot->format == FT_TS_GLYPH_FORMAT_SVG )
@@ -404,15 +395,37 @@
     else if ( slot->format != FT_TS_GLYPH_FORMAT_OUTLINE )
       return 1;
 
+    FT_TS_Outline_Get_CBox( &slot->outline, &cbox );
+
+    return ft_glyphslot_preset_bitmap_cbox( slot, mode, &cbox, origin );
+  }
+
+
+  FT_TS_BASE_DEF( FT_TS_Bool )
+  ft_glyphslot_preset_bitmap_cbox( FT_TS_GlyphSlot      slot,
+                                   FT_TS_Render_Mode    mode,
+                                   const FT_TS_BBox*    acbox,
+                                   const FT_TS_Vector*  origin )
+  {
+    FT_TS_Bitmap*  bitmap = &slot->bitmap;
+
+    FT_TS_Pixel_Mode  pixel_mode;
+
+    FT_TS_BBox  cbox, pbox;
+    FT_TS_Pos   x_shift = 0;
+    FT_TS_Pos   y_shift = 0;
+    FT_TS_Pos   x_left, y_top;
+    FT_TS_Pos   width, height, pitch;
+
+
     if ( origin )
     {
       x_shift = origin->x;
       y_shift = origin->y;
     }
 
-    /* compute the control box, and grid-fit it, */
-    /* taking into account the origin shift      */
-    FT_TS_Outline_Get_CBox( outline, &cbox );
+    /* grid-fit the control box, taking into account the origin shift */
+    cbox = *acbox;
 
     /* rough estimate of pixel box */
     pbox.xMin = ( cbox.xMin >> 6 ) + ( x_shift >> 6 );
@@ -481,6 +494,14 @@
       ft_lcd_padding( &cbox, slot, mode );
       goto Adjust;
 
+    case FT_TS_RENDER_MODE_GRAY2:
+      pixel_mode = FT_TS_PIXEL_MODE_GRAY2;
+      goto Adjust;
+
+    case FT_TS_RENDER_MODE_GRAY4:
+      pixel_mode = FT_TS_PIXEL_MODE_GRAY4;
+      goto Adjust;
+
     case FT_TS_RENDER_MODE_NORMAL:
     case FT_TS_RENDER_MODE_LIGHT:
     default:
@@ -509,6 +530,14 @@
       pitch  = FT_TS_PAD_CEIL( width, 4 );
       break;
 
+    case FT_TS_PIXEL_MODE_GRAY2:
+      pitch = ( width + 3 ) >> 2;
+      break;
+
+    case FT_TS_PIXEL_MODE_GRAY4:
+      pitch = ( width + 1 ) >> 1;
+      break;
+
     case FT_TS_PIXEL_MODE_LCD_V:
       height *= 3;
       /* fall through */
@@ -522,7 +551,9 @@
     slot->bitmap_top  = (FT_TS_Int)y_top;
 
     bitmap->pixel_mode = (unsigned char)pixel_mode;
-    bitmap->num_grays  = 256;
+    bitmap->num_grays  = pixel_mode == FT_TS_PIXEL_MODE_GRAY2 ? 4
+                       : pixel_mode == FT_TS_PIXEL_MODE_GRAY4 ? 16
+                                                           : 256;
     bitmap->width      = (unsigned int)width;
     bitmap->rows       = (unsigned int)height;
     bitmap->pitch      = pitch;
@@ -1153,42 +1184,38 @@
 #endif
             )
         {
-          FT_TS_Matrix  transform_matrix = {0};
-          
-          if (FT_TS_CHECK_FLIP_L2R(office_flags))
-          {
-              transform_matrix.xx = -0x10000L;
-              transform_matrix.yx =  0;
-              transform_matrix.xy =  0;
-              transform_matrix.yy =  0x10000L;
-              FT_TS_Outline_Transform( &slot->outline, &transform_matrix );
-          }
+          FT_TS_Matrix  transform_matrix = internal->transform_matrix;
+
 
-          if (FT_TS_CHECK_FLIP_T2B(office_flags))
+          /* fold the flips into the face transform, so that outlines */
+          /* are transformed in a single pass by the renderer; this   */
+          /* negates the matrix columns, which is exact               */
+          if ( slot->format == FT_TS_GLYPH_FORMAT_OUTLINE )
           {
-              transform_matrix.xx =  0x10000L;
-              transform_matrix.yx =  0;
-              transform_matrix.xy =  0;
-              transform_matrix.yy = -0x10000L;
-              FT_TS_Outline_Transform( &slot->outline, &transform_matrix );
+            if ( FT_TS_CHECK_FLIP_L2R( office_flags ) )
+            {
+              transform_matrix.xx = -transform_matrix.xx;
+              transform_matrix.yx = -transform_matrix.yx;
+            }
+
+            if ( FT_TS_CHECK_FLIP_T2B( office_flags ) )
+            {
+              transform_matrix.xy = -transform_matrix.xy;
+              transform_matrix.yy = -transform_matrix.yy;
+            }
           }
 
           error = renderer->clazz->transform_glyph(
                                      renderer, slot,
-                                     &internal->transform_matrix,
+                                     &transform_matrix,
                                      &internal->transform_delta );
         }
         else if ( slot->format == FT_TS_GLYPH_FORMAT_OUTLINE )
         {
           /* apply `standard' transformation if no renderer is available */
-          if ( internal->transform_flags & 1 )
-            FT_TS_Outline_Transform( &slot->outline,
-                                  &internal->transform_matrix );
-
-          if ( internal->transform_flags & 2 )
-            FT_TS_Outline_Translate( &slot->outline,
-                                  internal->transform_delta.x,
-                                  internal->transform_delta.y );
+          FT_TS_Outline_Transform_Translate( &slot->outline,
+                                          &internal->transform_matrix,
+                                          &internal->transform_delta );
         }
         else
         {
@@ -341,8 +341,9 @@
       while ( cur_max < new_max )
         cur_max += ( cur_max >> 1 ) + 16;
 
-      if ( FT_TS_RENEW_ARRAY( border->points, old_max, cur_max ) ||
-           FT_TS_RENEW_ARRAY( border->tags,   old_max, cur_max ) )
+      /* points and tags are always written before being read */
+      if ( FT_TS_QRENEW_ARRAY( border->points, old_max, cur_max ) ||
+           FT_TS_QRENEW_ARRAY( border->tags,   old_max, cur_max ) )
         goto Exit;
 
       border->max_points = cur_max;
@@ -2245,6 +2246,52 @@
   }
 
 
+  /*
+   * Create an outline glyph with the advance of `source' and room for
+   * the stroker's output.  The source outline is parsed directly, so
+   * only the result gets allocated; the stroker's borders keep their
+   * capacity from one glyph to the next.
+   */
+  static FT_TS_Error
+  ft_glyph_stroke_new( FT_TS_Glyph   source,
+                       FT_TS_UInt    num_points,
+                       FT_TS_UInt    num_contours,
+                       FT_TS_Glyph  *aglyph )
+  {
+    FT_TS_Error     error;
+    FT_TS_Glyph     glyph;
+    FT_TS_Outline*  outline;
+
+
+    error = FT_TS_New_Glyph( source->library,
+                             FT_TS_GLYPH_FORMAT_OUTLINE,
+                             &glyph );
+    if ( error )
+      goto Exit;
+
+    glyph->advance = source->advance;
+
+    outline = &( (FT_TS_OutlineGlyph)glyph )->outline;
+    error   = FT_TS_Outline_New( glyph->library,
+                                 num_points,
+                                 (FT_TS_Int)num_contours,
+                                 outline );
+    if ( error )
+    {
+      FT_TS_Done_Glyph( glyph );
+      goto Exit;
+    }
+
+    outline->n_points   = 0;
+    outline->n_contours = 0;
+
+    *aglyph = glyph;
+
+  Exit:
+    return error;
+  }
+
+
   /* documentation is in ftstroke.h */
 
   FT_TS_EXPORT_DEF( FT_TS_Error )
@@ -2264,41 +2311,26 @@
       goto Exit;
 
     {
-      FT_TS_Glyph  copy;
-
-
-      error = FT_TS_Glyph_Copy( glyph, &copy );
-      if ( error )
-        goto Exit;
-
-      glyph = copy;
-    }
-
-    {
-      FT_TS_OutlineGlyph  oglyph  = (FT_TS_OutlineGlyph)glyph;
-      FT_TS_Outline*      outline = &oglyph->outline;
+      FT_TS_OutlineGlyph  oglyph = (FT_TS_OutlineGlyph)glyph;
+      FT_TS_Glyph         stroked;
       FT_TS_UInt          num_points, num_contours;
 
 
-      error = FT_TS_Stroker_ParseOutline( stroker, outline, FALSE );
+      error = FT_TS_Stroker_ParseOutline( stroker, &oglyph->outline, FALSE );
       if ( error )
         goto Fail;
 
       FT_TS_Stroker_GetCounts( stroker, &num_points, &num_contours );
 
-      FT_TS_Outline_Done( glyph->library, outline );
-
-      error = FT_TS_Outline_New( glyph->library,
-                              num_points,
-                              (FT_TS_Int)num_contours,
-                              outline );
+      error = ft_glyph_stroke_new( glyph, num_points, num_contours,
+                                   &stroked );
       if ( error )
         goto Fail;
 
-      outline->n_points   = 0;
-      outline->n_contours = 0;
+      FT_TS_Stroker_Export( stroker,
+                            &( (FT_TS_OutlineGlyph)stroked )->outline );
 
-      FT_TS_Stroker_Export( stroker, outline );
+      glyph = stroked;
     }
 
     if ( destroy )
@@ -2308,9 +2340,6 @@
     goto Exit;
 
   Fail:
-    FT_TS_Done_Glyph( glyph );
-    glyph = NULL;
-
     if ( !destroy )
       *pglyph = NULL;
 
@@ -2338,21 +2367,11 @@
     if ( !glyph || glyph->clazz != &ft_outline_glyph_class )
       goto Exit;
 
-    {
-      FT_TS_Glyph  copy;
-
-
-      error = FT_TS_Glyph_Copy( glyph, &copy );
-      if ( error )
-        goto Exit;
-
-      glyph = copy;
-    }
-
     {
       FT_TS_OutlineGlyph   oglyph  = (FT_TS_OutlineGlyph)glyph;
       FT_TS_StrokerBorder  border;
       FT_TS_Outline*       outline = &oglyph->outline;
+      FT_TS_Glyph          stroked;
       FT_TS_UInt           num_points, num_contours;
 
 
@@ -2372,19 +2391,15 @@
       FT_TS_Stroker_GetBorderCounts( stroker, border,
                                   &num_points, &num_contours );
 
-      FT_TS_Outline_Done( glyph->library, outline );
-
-      error = FT_TS_Outline_New( glyph->library,
-                              num_points,
-                              (FT_TS_Int)num_contours,
-                              outline );
+      error = ft_glyph_stroke_new( glyph, num_points, num_contours,
+                                   &stroked );
       if ( error )
         goto Fail;
 
-      outline->n_points   = 0;
-      outline->n_contours = 0;
+      FT_TS_Stroker_ExportBorder( stroker, border,
+                                  &( (FT_TS_OutlineGlyph)stroked )->outline );
 
-      FT_TS_Stroker_ExportBorder( stroker, border, outline );
+      glyph = stroked;
     }
 
     if ( destroy )
@@ -2394,9 +2409,6 @@
     goto Exit;
 
   Fail:
-    FT_TS_Done_Glyph( glyph );
-    glyph = NULL;
-
     if ( !destroy )
       *pglyph = NULL;
 
@@ -60,8 +60,9 @@ ifneq ($(ftmac_c),)
 endif
 
 # for simplicity, we also handle `md5.c' (which gets included by `ftobjs.h')
-BASE_H := $(BASE_DIR)/ftbase.h  \
-          $(BASE_DIR)/md5.c     \
+BASE_H := $(BASE_DIR)/ftbase.h    \
+          $(BASE_DIR)/ftlcdsimd.h \
+          $(BASE_DIR)/md5.c       \
           $(BASE_DIR)/md5.h
 
 # Base layer `extensions' sources
@@ -26,6 +26,10 @@
 #include "ftcmanag.c"
 #include "ftcmru.c"
 #include "ftcsbits.c"
+#include "ftcsdf.c"
+#include "ftcshare.c"
+#include "ftcstroke.c"
+#include "ftcusage.c"
 
 
 /* END */
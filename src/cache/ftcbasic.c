@@ -19,6 +19,7 @@
 #include <freetype/internal/ftobjs.h>
 #include <freetype/internal/ftdebug.h>
 #include <freetype/ftcache.h>
+#include <freetype/tttables.h>
 #include "ftcglyph.h"
 #include "ftcimage.h"
 #include "ftcsbits.h"
@@ -62,6 +63,10 @@
     FTC_FamilyRec     family;
     FTC_BasicAttrRec  attrs;
 
+    /* font checksum for the shared sbit store, computed on demand */
+    FT_TS_Int         shared_state;  /* 0: unknown, 1: valid, -1: unshared */
+    FT_TS_UInt32      checksum[2];
+
   } FTC_BasicFamilyRec, *FTC_BasicFamily;
 
 
@@ -88,7 +93,8 @@
 
 
     FTC_Family_Init( FTC_FAMILY( family ), cache );
-    family->attrs = query->attrs;
+    family->attrs        = query->attrs;
+    family->shared_state = 0;
     return 0;
   }
 
@@ -156,6 +162,106 @@
   }
 
 
+  /* update two FNV-1a hashes with different offset bases */
+  static void
+  ftc_basic_checksum_update( FT_TS_UInt32*  checksum,
+                             const void*    data,
+                             FT_TS_ULong    length )
+  {
+    const FT_TS_Byte*  p     = (const FT_TS_Byte*)data;
+    const FT_TS_Byte*  limit = p + length;
+    FT_TS_UInt32       h0    = checksum[0];
+    FT_TS_UInt32       h1    = checksum[1];
+
+
+    for ( ; p < limit; p++ )
+    {
+      h0 = ( h0 ^ *p ) * 16777619UL;
+      h1 = ( h1 ^ *p ) * 16777619UL;
+    }
+
+    checksum[0] = h0;
+    checksum[1] = h1;
+  }
+
+
+  /*
+   * Face IDs are private to a process; glyphs in the shared sbit store are
+   * thus identified by a checksum of the font's names, basic metrics, file
+   * size, and (for SFNT fonts) the `head' table's checksum and date.
+   */
+  FT_TS_CALLBACK_DEF( FT_TS_Bool )
+  ftc_basic_family_get_shared_key( FTC_Family     ftcfamily,
+                                   FT_TS_UInt     gindex,
+                                   FTC_Manager    manager,
+                                   FTC_SharedKey  akey )
+  {
+    FTC_BasicFamily  family = (FTC_BasicFamily)ftcfamily;
+    FTC_Scaler       scaler = &family->attrs.scaler;
+
+
+    if ( family->shared_state == 0 )
+    {
+      FT_TS_Face      face;
+      TT_Header*      head;
+      FT_TS_UInt32*   checksum = family->checksum;
+      FT_TS_ULong     values[5];
+
+
+      family->shared_state = -1;
+
+      if ( FTC_Manager_LookupFace( manager, scaler->face_id, &face ) ||
+           FT_TS_IS_VARIATION( face )                                 )
+        return FALSE;
+
+      checksum[0] = 2166136261UL;
+      checksum[1] = 0x3BB2A9B5UL;
+
+      if ( face->family_name )
+        ftc_basic_checksum_update( checksum, face->family_name,
+                                   ft_strlen( face->family_name ) + 1 );
+      if ( face->style_name )
+        ftc_basic_checksum_update( checksum, face->style_name,
+                                   ft_strlen( face->style_name ) + 1 );
+
+      values[0] = (FT_TS_ULong)face->face_index;
+      values[1] = (FT_TS_ULong)face->num_glyphs;
+      values[2] = (FT_TS_ULong)face->units_per_EM;
+      values[3] = (FT_TS_ULong)face->face_flags;
+      values[4] = face->stream ? face->stream->size : 0;
+
+      head = (TT_Header*)FT_TS_Get_Sfnt_Table( face, FT_TS_SFNT_HEAD );
+      if ( head )
+      {
+        values[3] ^= (FT_TS_ULong)head->CheckSum_Adjust;
+        values[4] ^= head->Modified[0] ^ ( head->Modified[1] << 16 );
+      }
+
+      ftc_basic_checksum_update( checksum, values, sizeof ( values ) );
+
+      family->shared_state = 1;
+    }
+
+    if ( family->shared_state < 0 )
+      return FALSE;
+
+    FT_TS_ZERO( akey );
+
+    akey->checksum[0]  = family->checksum[0];
+    akey->checksum[1]  = family->checksum[1];
+    akey->width        = (FT_TS_UInt32)scaler->width;
+    akey->height       = (FT_TS_UInt32)scaler->height;
+    akey->x_res        = (FT_TS_UInt32)scaler->x_res;
+    akey->y_res        = (FT_TS_UInt32)scaler->y_res;
+    akey->pixel        = (FT_TS_UInt32)scaler->pixel;
+    akey->load_flags   = (FT_TS_UInt32)family->attrs.load_flags;
+    akey->office_flags = 0;
+    akey->gindex       = (FT_TS_UInt32)gindex;
+
+    return TRUE;
+  }
+
+
   FT_TS_CALLBACK_DEF( FT_TS_Error )
   ftc_basic_family_load_glyph( FTC_Family  ftcfamily,
                                FT_TS_UInt     gindex,
@@ -351,6 +457,12 @@
 #endif
     if ( !error )
     {
+      FTC_USAGE_RECORD( FTC_CACHE( cache )->manager,
+                        FTC_USAGE_KIND_IMAGE,
+                        &query.attrs.scaler,
+                        query.attrs.load_flags,
+                        gindex );
+
       *aglyph = FTC_INODE( node )->glyph;
 
       if ( anode )
@@ -419,6 +531,12 @@
                            error );
     if ( !error )
     {
+      FTC_USAGE_RECORD( FTC_CACHE( cache )->manager,
+                        FTC_USAGE_KIND_IMAGE,
+                        &query.attrs.scaler,
+                        query.attrs.load_flags,
+                        gindex );
+
       *aglyph = FTC_INODE( node )->glyph;
 
       if ( anode )
@@ -451,7 +569,8 @@
     },
 
     ftc_basic_family_get_count,
-    ftc_basic_family_load_bitmap
+    ftc_basic_family_load_bitmap,
+    ftc_basic_family_get_shared_key
   };
 
 
@@ -465,8 +584,8 @@
       ftc_basic_gnode_compare_faceid, /* FTC_Node_CompareFunc  node_remove_faceid */
       ftc_snode_free,                 /* FTC_Node_FreeFunc     node_free          */
 
-      sizeof ( FTC_GCacheRec ),
-      ftc_gcache_init,                /* FTC_Cache_InitFunc    cache_init         */
+      sizeof ( FTC_SCacheRec ),
+      ftc_scache_init,                /* FTC_Cache_InitFunc    cache_init         */
       ftc_gcache_done                 /* FTC_Cache_DoneFunc    cache_done         */
     },
 
@@ -485,6 +604,23 @@
   }
 
 
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_SBitCache_SetShared( FTC_SBitCache    cache,
+                           FTC_SharedCache  shared )
+  {
+    if ( !cache                                                          ||
+         FTC_CACHE( cache )->org_class !=
+           (FTC_CacheClass)&ftc_basic_sbit_cache_class                   )
+      return FT_TS_THROW( Invalid_Cache_Handle );
+
+    FTC_SCACHE( cache )->shared = shared;
+
+    return FT_TS_Err_Ok;
+  }
+
+
   /* documentation is in ftcache.h */
 
   FT_TS_EXPORT_DEF( FT_TS_Error )
@@ -553,6 +689,12 @@
     if ( error )
       goto Exit;
 
+    FTC_USAGE_RECORD( FTC_CACHE( cache )->manager,
+                      FTC_USAGE_KIND_SBIT,
+                      &query.attrs.scaler,
+                      query.attrs.load_flags,
+                      gindex );
+
     *ansbit = FTC_SNODE( node )->sbits +
               ( gindex - FTC_GNODE( node )->gindex );
 
@@ -622,6 +764,12 @@
     if ( error )
       goto Exit;
 
+    FTC_USAGE_RECORD( FTC_CACHE( cache )->manager,
+                      FTC_USAGE_KIND_SBIT,
+                      &query.attrs.scaler,
+                      query.attrs.load_flags,
+                      gindex );
+
     *ansbit = FTC_SNODE( node )->sbits +
               ( gindex - FTC_GNODE( node )->gindex );
 
@@ -75,6 +75,10 @@ FT_TS_BEGIN_HEADER
   ftc_gcache_done( FTC_Cache  cache );
 
 
+  FT_TS_LOCAL( FT_TS_Error )
+  ftc_scache_init( FTC_Cache  cache );
+
+
   FT_TS_LOCAL( FT_TS_Error )
   ftc_cache_init( FTC_Cache  cache );
 
@@ -402,6 +402,7 @@
     manager->nodes_list = NULL;
     manager->num_nodes  = 0;
     manager->num_caches = 0;
+    manager->usage      = NULL;
 
     *amanager = manager;
 
@@ -443,6 +444,9 @@
     FTC_MruList_Done( &manager->sizes );
     FTC_MruList_Done( &manager->faces );
 
+    FTC_Usage_Free( manager->usage );
+    manager->usage = NULL;
+
     manager->library = NULL;
     manager->memory  = NULL;
 
@@ -684,6 +688,10 @@
 
     for ( nn = 0; nn < manager->num_caches; nn++ )
       FTC_Cache_RemoveFaceID( manager->caches[nn], face_id );
+
+    /* the face ID might be reused for a different face */
+    if ( manager->usage )
+      FTC_Usage_RemoveFaceID( manager->usage, face_id );
   }
 
 
@@ -66,6 +66,7 @@
 #include <freetype/ftcache.h>
 #include "ftcmru.h"
 #include "ftccache.h"
+#include "ftcusage.h"
 
 
 FT_TS_BEGIN_HEADER
@@ -106,6 +107,8 @@ FT_TS_BEGIN_HEADER
     FT_TS_Pointer          request_data;
     FTC_Face_Requester  request_face;
 
+    FTC_Usage           usage;  /* non-NULL while recording usage */
+
   } FTC_ManagerRec;
 
 
@@ -67,11 +67,16 @@
     FTC_SNode  snode  = (FTC_SNode)ftcsnode;
     FTC_SBit   sbit   = snode->sbits;
     FT_TS_UInt    count  = snode->count;
+    FT_TS_UInt    shared = snode->shared;
     FT_TS_Memory  memory = cache->memory;
 
 
-    for ( ; count > 0; sbit++, count-- )
-      FT_TS_FREE( sbit->buffer );
+    for ( ; count > 0; sbit++, count--, shared >>= 1 )
+    {
+      /* bitmaps in shared memory are never released */
+      if ( !( shared & 1 ) )
+        FT_TS_FREE( sbit->buffer );
+    }
 
     FTC_GNode_Done( FTC_GNODE( snode ), cache );
 
@@ -99,16 +104,20 @@
    */
   static FT_TS_Error
   ftc_snode_load( FTC_SNode    snode,
-                  FTC_Manager  manager,
+                  FTC_Cache    cache,
                   FT_TS_UInt      gindex,
                   FT_TS_ULong    *asize )
   {
     FT_TS_Error          error;
+    FTC_Manager       manager = cache->manager;
     FTC_GNode         gnode  = FTC_GNODE( snode );
     FTC_Family        family = gnode->family;
     FT_TS_Face           face;
     FTC_SBit          sbit;
     FTC_SFamilyClass  clazz;
+    FTC_SharedCache   shared = FTC_SCACHE( cache )->shared;
+    FTC_SharedKeyRec  key;
+    FT_TS_UInt        mask;
 
 
     if ( gindex - gnode->gindex >= snode->count )
@@ -119,6 +128,27 @@
 
     sbit  = snode->sbits + ( gindex - gnode->gindex );
     clazz = (FTC_SFamilyClass)family->clazz;
+    mask  = 1U << ( gindex - gnode->gindex );
+
+    /* another process may have rendered this glyph already */
+    if ( shared )
+    {
+      if ( clazz->family_get_shared_key                              &&
+           clazz->family_get_shared_key( family, gindex,
+                                         manager, &key )             )
+      {
+        if ( FTC_SharedCache_Lookup( shared, &key, sbit ) )
+        {
+          snode->shared |= mask;
+          if ( asize )
+            *asize = 0;
+
+          return FT_TS_Err_Ok;
+        }
+      }
+      else
+        shared = NULL;
+    }
 
     error = clazz->family_load_glyph( family, gindex, manager, &face );
     if ( error )
@@ -185,9 +215,25 @@
         error = ftc_sbit_copy_bitmap( sbit, bitmap, manager->memory );
       }
 
+      /* publish the bitmap; the private copy is no longer needed then */
+      if ( shared && !error && sbit->buffer )
+      {
+        FT_TS_Memory  memory = manager->memory;
+        FT_TS_Byte*   buffer = sbit->buffer;
+
+
+        if ( FTC_SharedCache_Insert( shared, &key, sbit ) )
+        {
+          FT_TS_FREE( buffer );
+          snode->shared |= mask;
+        }
+      }
+
       /* now, compute size */
       if ( asize )
-        *asize = (FT_TS_ULong)FT_TS_ABS( sbit->pitch ) * sbit->height;
+        *asize = ( snode->shared & mask )
+                   ? 0
+                   : (FT_TS_ULong)FT_TS_ABS( sbit->pitch ) * sbit->height;
 
     } /* glyph loading successful */
 
@@ -245,7 +291,8 @@
 
       FTC_GNode_Init( FTC_GNODE( snode ), start, family );
 
-      snode->count = count;
+      snode->count  = count;
+      snode->shared = 0;
       for ( node_count = 0; node_count < count; node_count++ )
       {
         snode->sbits[node_count].width  = 255;
@@ -254,7 +301,7 @@
       }
 
       error = ftc_snode_load( snode,
-                              cache->manager,
+                              cache,
                               gindex,
                               NULL );
       if ( error )
@@ -290,6 +337,7 @@
     FTC_SNode  snode = (FTC_SNode)ftcsnode;
     FT_TS_UInt    count = snode->count;
     FTC_SBit   sbit  = snode->sbits;
+    FT_TS_UInt    shared = snode->shared;
     FT_TS_Int     pitch;
     FT_TS_Offset  size;
 
@@ -301,9 +349,10 @@
     /* the node itself */
     size = sizeof ( *snode );
 
-    for ( ; count > 0; count--, sbit++ )
+    for ( ; count > 0; count--, sbit++, shared >>= 1 )
     {
-      if ( sbit->buffer )
+      /* bitmaps in shared memory don't use our memory */
+      if ( sbit->buffer && !( shared & 1 ) )
       {
         pitch = sbit->pitch;
         if ( pitch < 0 )
@@ -395,7 +444,7 @@
 
         FTC_CACHE_TRYLOOP( cache )
         {
-          error = ftc_snode_load( snode, cache->manager, gindex, &size );
+          error = ftc_snode_load( snode, cache, gindex, &size );
         }
         FTC_CACHE_TRYLOOP_END( list_changed )
 
@@ -412,6 +461,15 @@
   }
 
 
+  FT_TS_LOCAL_DEF( FT_TS_Error )
+  ftc_scache_init( FTC_Cache  cache )
+  {
+    FTC_SCACHE( cache )->shared = NULL;
+
+    return ftc_gcache_init( cache );
+  }
+
+
 #ifdef FTC_INLINE
 
   FT_TS_LOCAL_DEF( FT_TS_Bool )
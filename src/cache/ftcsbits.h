@@ -22,6 +22,7 @@
 
 #include <freetype/ftcache.h>
 #include "ftcglyph.h"
+#include "ftcshare.h"
 
 
 FT_TS_BEGIN_HEADER
@@ -32,6 +33,7 @@ FT_TS_BEGIN_HEADER
   {
     FTC_GNodeRec  gnode;
     FT_TS_UInt       count;
+    FT_TS_UInt       shared;  /* bit i set if `sbits[i]' is in shared memory */
     FTC_SBitRec   sbits[FTC_SBIT_ITEMS_PER_NODE];
 
   } FTC_SNodeRec, *FTC_SNode;
@@ -51,11 +53,20 @@ FT_TS_BEGIN_HEADER
                                 FTC_Manager  manager,
                                 FT_TS_Face     *aface );
 
+  /* fill `akey' with a process-independent key for `gindex'; */
+  /* return FALSE if the family's glyphs can't be shared        */
+  typedef FT_TS_Bool
+  (*FTC_SFamily_GetSharedKeyFunc)( FTC_Family     family,
+                                   FT_TS_UInt     gindex,
+                                   FTC_Manager    manager,
+                                   FTC_SharedKey  akey );
+
   typedef struct  FTC_SFamilyClassRec_
   {
-    FTC_MruListClassRec        clazz;
-    FTC_SFamily_GetCountFunc   family_get_count;
-    FTC_SFamily_LoadGlyphFunc  family_load_glyph;
+    FTC_MruListClassRec           clazz;
+    FTC_SFamily_GetCountFunc      family_get_count;
+    FTC_SFamily_LoadGlyphFunc     family_load_glyph;
+    FTC_SFamily_GetSharedKeyFunc  family_get_shared_key;  /* optional */
 
   } FTC_SFamilyClassRec;
 
@@ -67,6 +78,16 @@ FT_TS_BEGIN_HEADER
           FTC_SFAMILY_CLASS( FTC_CACHE_GCACHE_CLASS( x )->family_class )
 
 
+  typedef struct  FTC_SCacheRec_
+  {
+    FTC_GCacheRec    gcache;
+    FTC_SharedCache  shared;  /* optional cross-process store */
+
+  } FTC_SCacheRec, *FTC_SCache;
+
+#define FTC_SCACHE( x )  ( (FTC_SCache)(x) )
+
+
   FT_TS_LOCAL( void )
   FTC_SNode_Free( FTC_SNode  snode,
                   FTC_Cache  cache );
@@ -0,0 +1,442 @@
+/****************************************************************************
+ *
+ * ftcsdf.c
+ *
+ *   FreeType signed distance field cache (body).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include <freetype/ftmodapi.h>
+#include "ftcglyph.h"
+#include <freetype/internal/ftmemory.h>
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+
+#include "ftccback.h"
+#include "ftcerror.h"
+
+#undef  FT_TS_COMPONENT
+#define FT_TS_COMPONENT  cache
+
+
+  /**************************************************************************
+   *
+   * Each SDF node holds the distance field of a single glyph.  The glyph
+   * is loaded with the family's scaler and load flags and rendered by the
+   * 'sdf' module (from the outline) or the 'bsdf' module (from a bitmap),
+   * after temporarily setting the module's `spread` property to the value
+   * of the family.
+   *
+   * The renderers' 8-bit output, which has the contour at value 128, is
+   * stored without padding as signed bytes with the contour at value~0.
+   * Distance fields are large compared to normal bitmaps; the weight of
+   * a node is thus its exact memory footprint.
+   *
+   */
+
+
+  typedef struct  FTC_SDFAttrRec_
+  {
+    FTC_ScalerRec  scaler;
+    FT_TS_UInt     load_flags;
+    FT_TS_UInt     spread;
+    FT_TS_Bool     from_bitmap;
+
+  } FTC_SDFAttrRec, *FTC_SDFAttrs;
+
+#define FTC_SDF_ATTR_COMPARE( a, b )                                   \
+          FT_TS_BOOL( FTC_SCALER_COMPARE( &(a)->scaler, &(b)->scaler ) && \
+                      (a)->load_flags  == (b)->load_flags           && \
+                      (a)->spread      == (b)->spread               && \
+                      (a)->from_bitmap == (b)->from_bitmap          )
+
+#define FTC_SDF_ATTR_HASH( a )                                       \
+          ( FTC_SCALER_HASH( &(a)->scaler ) + 31 * (a)->load_flags + \
+            97 * (a)->spread + 7 * (a)->from_bitmap                  )
+
+
+  typedef struct  FTC_SDFQueryRec_
+  {
+    FTC_GQueryRec   gquery;
+    FTC_SDFAttrRec  attrs;
+
+  } FTC_SDFQueryRec, *FTC_SDFQuery;
+
+
+  typedef struct  FTC_SDFFamilyRec_
+  {
+    FTC_FamilyRec   family;
+    FTC_SDFAttrRec  attrs;
+
+  } FTC_SDFFamilyRec, *FTC_SDFFamily;
+
+
+  typedef struct  FTC_DNodeRec_
+  {
+    FTC_GNodeRec  gnode;
+    FTC_SDFRec    sdf;
+
+  } FTC_DNodeRec, *FTC_DNode;
+
+#define FTC_DNODE( x )  ( (FTC_DNode)( x ) )
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                         SDF FAMILIES                          *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Bool )
+  ftc_sdf_family_compare( FTC_MruNode    ftcfamily,
+                          FT_TS_Pointer  ftcquery )
+  {
+    FTC_SDFFamily  family = (FTC_SDFFamily)ftcfamily;
+    FTC_SDFQuery   query  = (FTC_SDFQuery)ftcquery;
+
+
+    return FTC_SDF_ATTR_COMPARE( &family->attrs, &query->attrs );
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Error )
+  ftc_sdf_family_init( FTC_MruNode    ftcfamily,
+                       FT_TS_Pointer  ftcquery,
+                       FT_TS_Pointer  ftccache )
+  {
+    FTC_SDFFamily  family = (FTC_SDFFamily)ftcfamily;
+    FTC_SDFQuery   query  = (FTC_SDFQuery)ftcquery;
+    FTC_Cache      cache  = (FTC_Cache)ftccache;
+
+
+    FTC_Family_Init( FTC_FAMILY( family ), cache );
+    family->attrs = query->attrs;
+    return 0;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                           SDF NODES                           *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  /* render glyph `gindex' of the node's family into its distance field */
+  static FT_TS_Error
+  ftc_dnode_load( FTC_DNode    dnode,
+                  FTC_Manager  manager,
+                  FT_TS_UInt   gindex )
+  {
+    FT_TS_Error    error;
+    FT_TS_Memory   memory = manager->memory;
+    FTC_SDFFamily  family = (FTC_SDFFamily)FTC_GNODE( dnode )->family;
+    FTC_SDFAttrs   attrs  = &family->attrs;
+    FTC_SDF        sdf    = &dnode->sdf;
+    const char*    module = attrs->from_bitmap ? "bsdf" : "sdf";
+
+    FT_TS_Size       size;
+    FT_TS_GlyphSlot  slot;
+    FT_TS_Bitmap*    bitmap;
+    FT_TS_Int32      load_flags;
+    FT_TS_UInt       old_spread;
+
+
+    error = FTC_Manager_LookupSize( manager, &attrs->scaler, &size );
+    if ( error )
+      goto Exit;
+
+    slot       = size->face->glyph;
+    load_flags = (FT_TS_Int32)attrs->load_flags;
+
+    /* the source image is either a bitmap or an outline */
+    if ( attrs->from_bitmap )
+      load_flags |= FT_TS_LOAD_RENDER;
+    else
+    {
+      load_flags |= FT_TS_LOAD_NO_BITMAP;
+      load_flags &= ~FT_TS_LOAD_RENDER;
+    }
+
+    error = FT_TS_Load_Glyph( size->face, gindex, load_flags );
+    if ( error )
+      goto Exit;
+
+    sdf->xadvance = slot->advance.x;
+    sdf->yadvance = slot->advance.y;
+    sdf->spread   = attrs->spread;
+
+    if ( slot->format != ( attrs->from_bitmap ? FT_TS_GLYPH_FORMAT_BITMAP
+                                              : FT_TS_GLYPH_FORMAT_OUTLINE ) )
+    {
+      error = FT_TS_THROW( Invalid_Glyph_Format );
+      goto Exit;
+    }
+
+    /* glyphs without contours, e.g., spaces, have no distance field; */
+    /* the 'bsdf' module rejects empty bitmaps                         */
+    if ( attrs->from_bitmap && ( !slot->bitmap.width || !slot->bitmap.rows ) )
+      goto Exit;
+
+    /* the spread is a module property; restore it after rendering */
+    error = FT_TS_Property_Get( manager->library, module,
+                                "spread", &old_spread );
+    if ( error )
+      goto Exit;
+
+    if ( old_spread != attrs->spread )
+    {
+      error = FT_TS_Property_Set( manager->library, module,
+                                  "spread", &attrs->spread );
+      if ( error )
+        goto Exit;
+    }
+
+    error = FT_TS_Render_Glyph( slot, FT_TS_RENDER_MODE_SDF );
+
+    if ( old_spread != attrs->spread )
+      (void)FT_TS_Property_Set( manager->library, module,
+                                "spread", &old_spread );
+
+    if ( error )
+      goto Exit;
+
+    bitmap = &slot->bitmap;
+
+    sdf->width = bitmap->width;
+    sdf->rows  = bitmap->rows;
+    sdf->left  = slot->bitmap_left;
+    sdf->top   = slot->bitmap_top;
+
+    if ( bitmap->width && bitmap->rows )
+    {
+      FT_TS_Byte*  src   = bitmap->buffer;
+      FT_TS_Int    pitch = bitmap->pitch;
+      FT_TS_Char*  dst;
+      FT_TS_UInt   x, y;
+
+
+      if ( FT_TS_QALLOC_MULT( sdf->buffer, bitmap->rows, bitmap->width ) )
+        goto Exit;
+
+      if ( pitch < 0 )
+        src -= pitch * (FT_TS_Int)( bitmap->rows - 1 );
+
+      dst = sdf->buffer;
+
+      for ( y = 0; y < bitmap->rows; y++, src += pitch )
+        for ( x = 0; x < bitmap->width; x++ )
+          *dst++ = (FT_TS_Char)( src[x] ^ 0x80 );
+    }
+
+  Exit:
+    return error;
+  }
+
+
+  FT_TS_CALLBACK_DEF( void )
+  ftc_dnode_free( FTC_Node   ftcdnode,
+                  FTC_Cache  cache )
+  {
+    FTC_DNode     dnode  = (FTC_DNode)ftcdnode;
+    FT_TS_Memory  memory = cache->memory;
+
+
+    FT_TS_FREE( dnode->sdf.buffer );
+
+    FTC_GNode_Done( FTC_GNODE( dnode ), cache );
+    FT_TS_FREE( dnode );
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Error )
+  ftc_dnode_new( FTC_Node      *ftcpdnode,
+                 FT_TS_Pointer  ftcgquery,
+                 FTC_Cache      cache )
+  {
+    FTC_DNode   *pdnode = (FTC_DNode*)ftcpdnode;
+    FTC_GQuery   gquery = (FTC_GQuery)ftcgquery;
+    FT_TS_Memory  memory = cache->memory;
+    FT_TS_Error   error;
+    FTC_DNode     dnode  = NULL;
+
+
+    if ( !FT_TS_NEW( dnode ) )
+    {
+      FTC_GNode_Init( FTC_GNODE( dnode ), gquery->gindex, gquery->family );
+
+      error = ftc_dnode_load( dnode, cache->manager, gquery->gindex );
+      if ( error )
+      {
+        ftc_dnode_free( FTC_NODE( dnode ), cache );
+        dnode = NULL;
+      }
+    }
+
+    *pdnode = dnode;
+    return error;
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Offset )
+  ftc_dnode_weight( FTC_Node   ftcdnode,
+                    FTC_Cache  cache )
+  {
+    FTC_DNode  dnode = (FTC_DNode)ftcdnode;
+
+    FT_TS_UNUSED( cache );
+
+
+    return sizeof ( *dnode ) +
+           (FT_TS_Offset)dnode->sdf.width * dnode->sdf.rows;
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Bool )
+  ftc_dnode_compare_faceid( FTC_Node       ftcdnode,
+                            FT_TS_Pointer  ftcface_id,
+                            FTC_Cache      cache,
+                            FT_TS_Bool*    list_changed )
+  {
+    FTC_GNode      gnode   = (FTC_GNode)ftcdnode;
+    FTC_FaceID     face_id = (FTC_FaceID)ftcface_id;
+    FTC_SDFFamily  family  = (FTC_SDFFamily)gnode->family;
+    FT_TS_Bool     result;
+
+
+    if ( list_changed )
+      *list_changed = FALSE;
+    result = FT_TS_BOOL( family->attrs.scaler.face_id == face_id );
+    if ( result )
+      FTC_GNode_UnselectFamily( gnode, cache );
+    return result;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                           SDF CACHE                           *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  static
+  const FTC_MruListClassRec  ftc_sdf_family_class =
+  {
+    sizeof ( FTC_SDFFamilyRec ),
+
+    ftc_sdf_family_compare,   /* FTC_MruNode_CompareFunc  node_compare */
+    ftc_sdf_family_init,      /* FTC_MruNode_InitFunc     node_init    */
+    NULL,                     /* FTC_MruNode_ResetFunc    node_reset   */
+    NULL                      /* FTC_MruNode_DoneFunc     node_done    */
+  };
+
+
+  static
+  const FTC_GCacheClassRec  ftc_sdf_cache_class =
+  {
+    {
+      ftc_dnode_new,            /* FTC_Node_NewFunc      node_new           */
+      ftc_dnode_weight,         /* FTC_Node_WeightFunc   node_weight        */
+      ftc_gnode_compare,        /* FTC_Node_CompareFunc  node_compare       */
+      ftc_dnode_compare_faceid, /* FTC_Node_CompareFunc  node_remove_faceid */
+      ftc_dnode_free,           /* FTC_Node_FreeFunc     node_free          */
+
+      sizeof ( FTC_GCacheRec ),
+      ftc_gcache_init,          /* FTC_Cache_InitFunc    cache_init         */
+      ftc_gcache_done           /* FTC_Cache_DoneFunc    cache_done         */
+    },
+
+    (FTC_MruListClass)&ftc_sdf_family_class
+  };
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_SDFCache_New( FTC_Manager    manager,
+                    FTC_SDFCache  *acache )
+  {
+    return FTC_GCache_New( manager, &ftc_sdf_cache_class,
+                           (FTC_GCache*)acache );
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_SDFCache_Lookup( FTC_SDFCache  cache,
+                       FTC_SDFType   type,
+                       FT_TS_UInt    gindex,
+                       FTC_SDF      *asdf,
+                       FTC_Node     *anode )
+  {
+    FTC_SDFQueryRec  query;
+    FTC_Node         node = 0; /* make compiler happy */
+    FT_TS_Error      error;
+    FT_TS_Offset     hash;
+
+
+    if ( anode )
+      *anode = NULL;
+
+    /* other argument checks delayed to `FTC_Cache_Lookup' */
+    if ( !asdf || !type )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *asdf = NULL;
+
+    query.attrs.scaler.face_id = type->face_id;
+    query.attrs.scaler.width   = type->width;
+    query.attrs.scaler.height  = type->height;
+    query.attrs.scaler.pixel   = 1;
+    query.attrs.scaler.x_res   = 0;  /* make compilers happy */
+    query.attrs.scaler.y_res   = 0;
+    query.attrs.load_flags     = (FT_TS_UInt)type->flags;
+    query.attrs.spread         = type->spread;
+    query.attrs.from_bitmap    = type->from_bitmap ? 1 : 0;
+
+    hash = FTC_SDF_ATTR_HASH( &query.attrs ) + gindex;
+
+    FTC_GCACHE_LOOKUP_CMP( cache,
+                           ftc_sdf_family_compare,
+                           FTC_GNode_Compare,
+                           hash, gindex,
+                           &query,
+                           node,
+                           error );
+    if ( error )
+      goto Exit;
+
+    *asdf = &FTC_DNODE( node )->sdf;
+
+    if ( anode )
+    {
+      *anode = node;
+      node->ref_count++;
+    }
+
+  Exit:
+    return error;
+  }
+
+
+/* END */
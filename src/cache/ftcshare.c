@@ -0,0 +1,564 @@
+/****************************************************************************
+ *
+ * ftcshare.c
+ *
+ *   FreeType Cache cross-process glyph bitmap store (body).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include "ftcshare.h"
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+
+#include "ftcerror.h"
+
+
+#undef  FT_TS_COMPONENT
+#define FT_TS_COMPONENT  cache
+
+
+#ifdef FT_TS_CONFIG_OPTION_SHARED_CACHE
+
+#if !defined( __GNUC__ ) && !defined( __clang__ )
+#error "FT_TS_CONFIG_OPTION_SHARED_CACHE needs GCC-style atomic builtins"
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <errno.h>
+
+
+#define FTC_SHARED_MAGIC    0x46544353UL  /* `FTCS' */
+#define FTC_SHARED_VERSION  1
+
+  /* index slot states */
+#define FTC_SHARED_EMPTY  0
+#define FTC_SHARED_BUSY   1  /* claimed, key not yet valid */
+#define FTC_SHARED_READY  2
+
+  /* maximum number of slots examined per lookup or insertion */
+#define FTC_SHARED_MAX_PROBES  32
+
+  /* slab bytes planned per index slot; small bitmaps are rarely larger */
+#define FTC_SHARED_BYTES_PER_SLOT  512
+
+  /* Largest segment size.  Racing allocations can push `slab_used' */
+  /* past the slab end before they fail; the remaining 2GByte of     */
+  /* 32-bit range keep the counter from wrapping.                    */
+#define FTC_SHARED_MAX_SIZE  0x80000000UL
+
+  /* how often we yield while waiting for another process to set up the */
+  /* segment before giving up                                           */
+#define FTC_SHARED_MAX_WAIT  10000
+
+#define FTC_SHARED_LOAD( p )       __atomic_load_n( p, __ATOMIC_ACQUIRE )
+#define FTC_SHARED_STORE( p, v )   __atomic_store_n( p, v, __ATOMIC_RELEASE )
+#define FTC_SHARED_FETCH_ADD( p, v )                     \
+          __atomic_fetch_add( p, v, __ATOMIC_RELAXED )
+#define FTC_SHARED_CAS( p, expected, desired )                         \
+          ftc_shared_cas( p, expected, desired )
+
+#define FTC_SHARED_ALIGN( x )  ( ( (x) + 7 ) & ~7UL )
+
+
+  typedef struct  FTC_SharedHeaderRec_
+  {
+    FT_TS_UInt32  magic;        /* written last by the creator */
+    FT_TS_UInt32  version;
+    FT_TS_UInt32  num_slots;    /* a power of 2 */
+    FT_TS_UInt32  slab_offset;  /* relative to the segment start */
+    FT_TS_UInt32  slab_size;
+    FT_TS_UInt32  slab_used;    /* atomic bump allocator */
+
+  } FTC_SharedHeaderRec, *FTC_SharedHeader;
+
+
+  typedef struct  FTC_SharedSlotRec_
+  {
+    FT_TS_UInt32      state;
+    FT_TS_UInt32      hash;
+    FT_TS_UInt32      offset;   /* payload offset relative to the slab */
+    FT_TS_UInt32      reserved;
+    FTC_SharedKeyRec  key;
+
+  } FTC_SharedSlotRec, *FTC_SharedSlot;
+
+
+  /* a payload is this header, followed by the bitmap rows */
+  typedef struct  FTC_SharedGlyphRec_
+  {
+    FT_TS_Byte   width;
+    FT_TS_Byte   height;
+    FT_TS_Char   left;
+    FT_TS_Char   top;
+
+    FT_TS_Byte   format;
+    FT_TS_Byte   max_grays;
+    FT_TS_Short  pitch;
+    FT_TS_Char   xadvance;
+    FT_TS_Char   yadvance;
+
+    FT_TS_Byte   reserved[6];
+
+  } FTC_SharedGlyphRec, *FTC_SharedGlyph;
+
+
+  typedef struct  FTC_SharedCacheRec_
+  {
+    FT_TS_Memory      memory;
+
+    FT_TS_Byte*       base;
+    FT_TS_ULong       size;
+
+    FTC_SharedHeader  header;
+    FTC_SharedSlot    slots;
+    FT_TS_Byte*       slab;
+    FT_TS_ULong       slab_size;  /* as validated when opening */
+
+  } FTC_SharedCacheRec;
+
+
+  static FT_TS_Bool
+  ftc_shared_cas( FT_TS_UInt32*  p,
+                  FT_TS_UInt32   expected,
+                  FT_TS_UInt32   desired )
+  {
+    return FT_TS_BOOL( __atomic_compare_exchange_n( p,
+                                                    &expected,
+                                                    desired,
+                                                    0,
+                                                    __ATOMIC_ACQ_REL,
+                                                    __ATOMIC_ACQUIRE ) );
+  }
+
+
+  /* FNV-1a over the key fields */
+  static FT_TS_UInt32
+  ftc_shared_hash( FTC_SharedKey  key )
+  {
+    const FT_TS_Byte*  p     = (const FT_TS_Byte*)key;
+    const FT_TS_Byte*  limit = p + sizeof ( *key );
+    FT_TS_UInt32       hash  = 2166136261UL;
+
+
+    for ( ; p < limit; p++ )
+    {
+      hash ^= *p;
+      hash *= 16777619UL;
+    }
+
+    return hash;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_SharedCache_Open( FT_TS_Library     library,
+                        const char*       name,
+                        FT_TS_ULong       size,
+                        FTC_SharedCache  *ashared )
+  {
+    FT_TS_Error       error;
+    FT_TS_Memory      memory;
+    FTC_SharedCache   shared = NULL;
+    FTC_SharedHeader  header;
+    FT_TS_Byte*       base   = (FT_TS_Byte*)MAP_FAILED;
+    FT_TS_Bool        create = TRUE;
+    struct stat       st;
+    int               fd;
+    int               wait;
+
+
+    if ( !library )
+      return FT_TS_THROW( Invalid_Library_Handle );
+
+    if ( !name || !ashared )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *ashared = NULL;
+    memory   = library->memory;
+
+    if ( size > FTC_SHARED_MAX_SIZE )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( size < sizeof ( FTC_SharedHeaderRec ) +
+                  64 * ( sizeof ( FTC_SharedSlotRec ) +
+                         FTC_SHARED_BYTES_PER_SLOT )   )
+      size = sizeof ( FTC_SharedHeaderRec ) +
+               64 * ( sizeof ( FTC_SharedSlotRec ) +
+                      FTC_SHARED_BYTES_PER_SLOT );
+
+    fd = shm_open( name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+    if ( fd < 0 && errno == EEXIST )
+    {
+      create = FALSE;
+      fd     = shm_open( name, O_RDWR, 0 );
+    }
+    if ( fd < 0 )
+    {
+      FT_TS_ERROR(( "FTC_SharedCache_Open: cannot open `%s'\n", name ));
+      return FT_TS_THROW( Cannot_Open_Resource );
+    }
+
+    if ( create )
+    {
+      if ( ftruncate( fd, (off_t)size ) )
+      {
+        error = FT_TS_THROW( Out_Of_Memory );
+        shm_unlink( name );
+        goto Exit;
+      }
+    }
+    else
+    {
+      /* wait until the creator has sized the segment */
+      for ( wait = 0; ; wait++ )
+      {
+        if ( fstat( fd, &st ) )
+        {
+          error = FT_TS_THROW( Cannot_Open_Resource );
+          goto Exit;
+        }
+
+        if ( st.st_size >= (off_t)sizeof ( FTC_SharedHeaderRec ) )
+          break;
+
+        if ( wait == FTC_SHARED_MAX_WAIT )
+        {
+          error = FT_TS_THROW( Invalid_Stream_Operation );
+          goto Exit;
+        }
+        sched_yield();
+      }
+
+      size = (FT_TS_ULong)st.st_size;
+    }
+
+    base = (FT_TS_Byte*)mmap( NULL, size,
+                              PROT_READ | PROT_WRITE, MAP_SHARED,
+                              fd, 0 );
+    if ( base == (FT_TS_Byte*)MAP_FAILED )
+    {
+      error = FT_TS_THROW( Out_Of_Memory );
+      goto Exit;
+    }
+
+    header = (FTC_SharedHeader)base;
+
+    if ( create )
+    {
+      FT_TS_ULong  num_slots = 64;
+      FT_TS_ULong  slots_size;
+
+
+      while ( ( num_slots * 2 ) * ( sizeof ( FTC_SharedSlotRec ) +
+                                    FTC_SHARED_BYTES_PER_SLOT )   <=
+                size - sizeof ( FTC_SharedHeaderRec )               )
+        num_slots *= 2;
+
+      slots_size = num_slots * sizeof ( FTC_SharedSlotRec );
+
+      /* the segment is zero-filled, i.e., all slots are empty */
+      header->version     = FTC_SHARED_VERSION;
+      header->num_slots   = (FT_TS_UInt32)num_slots;
+      header->slab_offset = (FT_TS_UInt32)FTC_SHARED_ALIGN(
+                              sizeof ( FTC_SharedHeaderRec ) + slots_size );
+      header->slab_size   = (FT_TS_UInt32)( size - header->slab_offset );
+      header->slab_used   = 0;
+
+      FTC_SHARED_STORE( &header->magic, FTC_SHARED_MAGIC );
+    }
+    else
+    {
+      for ( wait = 0;
+            FTC_SHARED_LOAD( &header->magic ) != FTC_SHARED_MAGIC;
+            wait++ )
+      {
+        if ( wait == FTC_SHARED_MAX_WAIT )
+        {
+          error = FT_TS_THROW( Invalid_Stream_Operation );
+          goto Exit;
+        }
+        sched_yield();
+      }
+
+      if ( header->version != FTC_SHARED_VERSION                    ||
+           header->slab_offset > size                               ||
+           header->slab_size > size - header->slab_offset           ||
+           header->slab_size > FTC_SHARED_MAX_SIZE                  ||
+           header->num_slots == 0                                   ||
+           ( header->num_slots & ( header->num_slots - 1 ) ) != 0   ||
+           header->num_slots > ( header->slab_offset -
+                                   sizeof ( FTC_SharedHeaderRec ) ) /
+                                 sizeof ( FTC_SharedSlotRec )       )
+      {
+        FT_TS_ERROR(( "FTC_SharedCache_Open:"
+                      " `%s' has an incompatible layout\n", name ));
+        error = FT_TS_THROW( Invalid_File_Format );
+        goto Exit;
+      }
+    }
+
+    if ( FT_TS_NEW( shared ) )
+      goto Exit;
+
+    shared->memory = memory;
+    shared->base   = base;
+    shared->size   = size;
+    shared->header = header;
+    shared->slots  = (FTC_SharedSlot)( base + sizeof ( *header ) );
+    shared->slab   = base + header->slab_offset;
+
+    shared->slab_size = header->slab_size;
+
+    *ashared = shared;
+    base     = (FT_TS_Byte*)MAP_FAILED;  /* now owned by `shared' */
+    error    = FT_TS_Err_Ok;
+
+  Exit:
+    if ( base != (FT_TS_Byte*)MAP_FAILED )
+      munmap( base, size );
+    close( fd );
+
+    return error;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( void )
+  FTC_SharedCache_Close( FTC_SharedCache  shared )
+  {
+    FT_TS_Memory  memory;
+
+
+    if ( !shared )
+      return;
+
+    memory = shared->memory;
+
+    munmap( shared->base, shared->size );
+    FT_TS_FREE( shared );
+  }
+
+
+  FT_TS_LOCAL_DEF( FT_TS_Bool )
+  FTC_SharedCache_Lookup( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit )
+  {
+    FTC_SharedHeader  header = shared->header;
+    FT_TS_UInt32      hash   = ftc_shared_hash( key );
+    FT_TS_UInt32      mask   = header->num_slots - 1;
+    FT_TS_UInt32      idx    = hash & mask;
+    FT_TS_UInt        probe;
+
+
+    for ( probe = 0; probe < FTC_SHARED_MAX_PROBES; probe++ )
+    {
+      FTC_SharedSlot  slot  = shared->slots + idx;
+      FT_TS_UInt32    state = FTC_SHARED_LOAD( &slot->state );
+
+
+      if ( state == FTC_SHARED_EMPTY )
+        break;
+
+      if ( state == FTC_SHARED_READY                              &&
+           slot->hash == hash                                     &&
+           !ft_memcmp( &slot->key, key, sizeof ( *key ) )          )
+      {
+        FT_TS_ULong      offset = slot->offset;
+        FTC_SharedGlyph  glyph;
+        FT_TS_Byte       height;
+        FT_TS_Short      pitch;
+
+
+        /* the segment is writable by other processes; */
+        /* never trust it to stay within the slab      */
+        if ( shared->slab_size < sizeof ( FTC_SharedGlyphRec )          ||
+             offset > shared->slab_size - sizeof ( FTC_SharedGlyphRec ) )
+          return FALSE;
+
+        glyph  = (FTC_SharedGlyph)( shared->slab + offset );
+        height = glyph->height;
+        pitch  = glyph->pitch;
+
+        if ( (FT_TS_ULong)FT_TS_ABS( pitch ) * height >
+               shared->slab_size - offset - sizeof ( FTC_SharedGlyphRec ) )
+          return FALSE;
+
+        sbit->width     = glyph->width;
+        sbit->height    = height;
+        sbit->left      = glyph->left;
+        sbit->top       = glyph->top;
+        sbit->format    = glyph->format;
+        sbit->max_grays = glyph->max_grays;
+        sbit->pitch     = pitch;
+        sbit->xadvance  = glyph->xadvance;
+        sbit->yadvance  = glyph->yadvance;
+        sbit->buffer    = (FT_TS_Byte*)( glyph + 1 );
+
+        return TRUE;
+      }
+
+      idx = ( idx + 1 ) & mask;
+    }
+
+    return FALSE;
+  }
+
+
+  FT_TS_LOCAL_DEF( FT_TS_Bool )
+  FTC_SharedCache_Insert( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit )
+  {
+    FTC_SharedHeader  header = shared->header;
+    FT_TS_UInt32      hash   = ftc_shared_hash( key );
+    FT_TS_UInt32      mask   = header->num_slots - 1;
+    FT_TS_UInt32      idx    = hash & mask;
+    FT_TS_ULong       size;
+    FT_TS_ULong       bytes;
+    FT_TS_UInt32      offset;
+    FTC_SharedGlyph   glyph;
+    FT_TS_UInt        probe;
+
+
+    /* only the slab allocation is rounded up */
+    size  = (FT_TS_ULong)FT_TS_ABS( sbit->pitch ) * sbit->height;
+    bytes = FTC_SHARED_ALIGN( sizeof ( FTC_SharedGlyphRec ) + size );
+
+    /* check first so that a full slab doesn't make the counter wrap */
+    if ( bytes > shared->slab_size                                          ||
+         FTC_SHARED_LOAD( &header->slab_used ) > shared->slab_size - bytes )
+      return FALSE;
+
+    offset = FTC_SHARED_FETCH_ADD( &header->slab_used, (FT_TS_UInt32)bytes );
+    if ( offset > shared->slab_size - bytes )
+      return FALSE;
+
+    glyph = (FTC_SharedGlyph)( shared->slab + offset );
+
+    glyph->width     = sbit->width;
+    glyph->height    = sbit->height;
+    glyph->left      = sbit->left;
+    glyph->top       = sbit->top;
+    glyph->format    = sbit->format;
+    glyph->max_grays = sbit->max_grays;
+    glyph->pitch     = sbit->pitch;
+    glyph->xadvance  = sbit->xadvance;
+    glyph->yadvance  = sbit->yadvance;
+
+    FT_TS_MEM_COPY( glyph + 1, sbit->buffer, size );
+
+    for ( probe = 0; probe < FTC_SHARED_MAX_PROBES; probe++ )
+    {
+      FTC_SharedSlot  slot = shared->slots + idx;
+
+
+      if ( FTC_SHARED_CAS( &slot->state,
+                           FTC_SHARED_EMPTY,
+                           FTC_SHARED_BUSY ) )
+      {
+        slot->hash   = hash;
+        slot->offset = offset;
+        slot->key    = *key;
+
+        /* publish the slot */
+        FTC_SHARED_STORE( &slot->state, FTC_SHARED_READY );
+
+        sbit->buffer = (FT_TS_Byte*)( glyph + 1 );
+        return TRUE;
+      }
+
+      /* another process might have been faster; we still use our */
+      /* own payload copy rather than trusting the other slot      */
+      if ( FTC_SHARED_LOAD( &slot->state ) == FTC_SHARED_READY &&
+           slot->hash == hash                                  &&
+           !ft_memcmp( &slot->key, key, sizeof ( *key ) )       )
+      {
+        sbit->buffer = (FT_TS_Byte*)( glyph + 1 );
+        return TRUE;
+      }
+
+      idx = ( idx + 1 ) & mask;
+    }
+
+    return FALSE;
+  }
+
+#else /* !FT_TS_CONFIG_OPTION_SHARED_CACHE */
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_SharedCache_Open( FT_TS_Library     library,
+                        const char*       name,
+                        FT_TS_ULong       size,
+                        FTC_SharedCache  *ashared )
+  {
+    FT_TS_UNUSED( library );
+    FT_TS_UNUSED( name );
+    FT_TS_UNUSED( size );
+
+    if ( ashared )
+      *ashared = NULL;
+
+    return FT_TS_THROW( Unimplemented_Feature );
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( void )
+  FTC_SharedCache_Close( FTC_SharedCache  shared )
+  {
+    FT_TS_UNUSED( shared );
+  }
+
+
+  FT_TS_LOCAL_DEF( FT_TS_Bool )
+  FTC_SharedCache_Lookup( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit )
+  {
+    FT_TS_UNUSED( shared );
+    FT_TS_UNUSED( key );
+    FT_TS_UNUSED( sbit );
+
+    return FALSE;
+  }
+
+
+  FT_TS_LOCAL_DEF( FT_TS_Bool )
+  FTC_SharedCache_Insert( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit )
+  {
+    FT_TS_UNUSED( shared );
+    FT_TS_UNUSED( key );
+    FT_TS_UNUSED( sbit );
+
+    return FALSE;
+  }
+
+#endif /* !FT_TS_CONFIG_OPTION_SHARED_CACHE */
+
+
+/* END */
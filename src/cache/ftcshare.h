@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * ftcshare.h
+ *
+ *   FreeType Cache cross-process glyph bitmap store (specification).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+  /**************************************************************************
+   *
+   * A shared store is a POSIX shared memory segment holding rendered small
+   * bitmaps, so that several processes with their own cache managers can
+   * share them instead of rendering and storing them each.
+   *
+   * The segment starts with a header, followed by an open-addressed index
+   * and a slab area for the bitmaps.  Index slots and slab space are only
+   * ever allocated, never released, using atomic operations; this makes
+   * the store lock-free for both readers and writers.  A slot becomes
+   * visible to readers only after its key and payload have been written.
+   *
+   * Since face IDs and pointers are meaningless in other processes, glyphs
+   * are keyed by a checksum of the font file and the scaler values.
+   *
+   */
+
+
+#ifndef FTCSHARE_H_
+#define FTCSHARE_H_
+
+
+#include <freetype/ftcache.h>
+
+
+FT_TS_BEGIN_HEADER
+
+
+  typedef struct  FTC_SharedKeyRec_
+  {
+    FT_TS_UInt32  checksum[2];  /* identifies the font across processes */
+    FT_TS_UInt32  width;
+    FT_TS_UInt32  height;
+    FT_TS_UInt32  x_res;
+    FT_TS_UInt32  y_res;
+    FT_TS_UInt32  pixel;
+    FT_TS_UInt32  load_flags;
+    FT_TS_UInt32  office_flags;
+    FT_TS_UInt32  gindex;
+
+  } FTC_SharedKeyRec, *FTC_SharedKey;
+
+
+  /* Look up `key'.  On success, `sbit' is filled and its buffer points */
+  /* into the shared segment.                                           */
+  FT_TS_LOCAL( FT_TS_Bool )
+  FTC_SharedCache_Lookup( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit );
+
+  /* Copy `sbit' into the shared segment.  On success, `sbit->buffer' is */
+  /* changed to point to the shared copy; the caller must release the    */
+  /* old buffer.                                                         */
+  FT_TS_LOCAL( FT_TS_Bool )
+  FTC_SharedCache_Insert( FTC_SharedCache  shared,
+                          FTC_SharedKey    key,
+                          FTC_SBit         sbit );
+
+
+FT_TS_END_HEADER
+
+#endif /* FTCSHARE_H_ */
+
+
+/* END */
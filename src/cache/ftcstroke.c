@@ -0,0 +1,410 @@
+/****************************************************************************
+ *
+ * ftcstroke.c
+ *
+ *   FreeType stroked glyph cache (body).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include <freetype/ftstroke.h>
+#include "ftcglyph.h"
+#include "ftcimage.h"
+#include <freetype/internal/ftmemory.h>
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+
+#include "ftccback.h"
+#include "ftcerror.h"
+
+#undef  FT_TS_COMPONENT
+#define FT_TS_COMPONENT  cache
+
+
+  /**************************************************************************
+   *
+   * A stroke cache is a glyph image cache whose families additionally
+   * carry the stroker parameters.  Its nodes are ordinary image nodes
+   * (see `ftcimage.c`), holding either the stroked outline or its bitmap.
+   *
+   * Every cache owns a single @FT_TS_Stroker, which is used for all
+   * glyphs.  The stroker's borders keep their arrays across glyphs, so
+   * after a few glyphs the only allocation per glyph is the result.
+   *
+   */
+
+
+  typedef struct  FTC_StrokeAttrRec_
+  {
+    FTC_ScalerRec           scaler;
+    FT_TS_UInt              load_flags;
+    FT_TS_Fixed             radius;
+    FT_TS_Stroker_LineCap   line_cap;
+    FT_TS_Stroker_LineJoin  line_join;
+    FT_TS_Fixed             miter_limit;
+
+  } FTC_StrokeAttrRec, *FTC_StrokeAttrs;
+
+#define FTC_STROKE_ATTR_COMPARE( a, b )                                \
+          FT_TS_BOOL( FTC_SCALER_COMPARE( &(a)->scaler, &(b)->scaler ) && \
+                      (a)->load_flags  == (b)->load_flags           && \
+                      (a)->radius      == (b)->radius               && \
+                      (a)->line_cap    == (b)->line_cap             && \
+                      (a)->line_join   == (b)->line_join            && \
+                      (a)->miter_limit == (b)->miter_limit          )
+
+#define FTC_STROKE_ATTR_HASH( a )                                     \
+          ( FTC_SCALER_HASH( &(a)->scaler ) + 31 * (a)->load_flags +  \
+            (FT_TS_Offset)(a)->radius * 97 +                          \
+            (FT_TS_Offset)(a)->line_cap * 7 +                         \
+            (FT_TS_Offset)(a)->line_join * 13                         )
+
+
+  typedef struct  FTC_StrokeQueryRec_
+  {
+    FTC_GQueryRec      gquery;
+    FTC_StrokeAttrRec  attrs;
+
+  } FTC_StrokeQueryRec, *FTC_StrokeQuery;
+
+
+  typedef struct  FTC_StrokeFamilyRec_
+  {
+    FTC_FamilyRec      family;
+    FTC_StrokeAttrRec  attrs;
+
+  } FTC_StrokeFamilyRec, *FTC_StrokeFamily;
+
+
+  typedef struct  FTC_StrokeCacheRec_
+  {
+    FTC_GCacheRec  gcache;
+    FT_TS_Stroker  stroker;
+
+  } FTC_StrokeCacheRec;
+
+#define FTC_STROKE_CACHE( x )  ( (FTC_StrokeCache)(x) )
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                        STROKE FAMILIES                        *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Bool )
+  ftc_stroke_family_compare( FTC_MruNode    ftcfamily,
+                             FT_TS_Pointer  ftcquery )
+  {
+    FTC_StrokeFamily  family = (FTC_StrokeFamily)ftcfamily;
+    FTC_StrokeQuery   query  = (FTC_StrokeQuery)ftcquery;
+
+
+    return FTC_STROKE_ATTR_COMPARE( &family->attrs, &query->attrs );
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Error )
+  ftc_stroke_family_init( FTC_MruNode    ftcfamily,
+                          FT_TS_Pointer  ftcquery,
+                          FT_TS_Pointer  ftccache )
+  {
+    FTC_StrokeFamily  family = (FTC_StrokeFamily)ftcfamily;
+    FTC_StrokeQuery   query  = (FTC_StrokeQuery)ftcquery;
+    FTC_Cache         cache  = (FTC_Cache)ftccache;
+
+
+    FTC_Family_Init( FTC_FAMILY( family ), cache );
+    family->attrs = query->attrs;
+    return 0;
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Error )
+  ftc_stroke_family_load_glyph( FTC_Family    ftcfamily,
+                                FT_TS_UInt    gindex,
+                                FTC_Cache     cache,
+                                FT_TS_Glyph  *aglyph )
+  {
+    FTC_StrokeFamily  family  = (FTC_StrokeFamily)ftcfamily;
+    FTC_StrokeAttrs   attrs   = &family->attrs;
+    FT_TS_Stroker     stroker = FTC_STROKE_CACHE( cache )->stroker;
+    FT_TS_Error       error;
+    FT_TS_Size        size;
+    FT_TS_GlyphSlot   slot;
+    FT_TS_Glyph       glyph;
+    FT_TS_Outline*    outline;
+    FT_TS_UInt        num_points, num_contours;
+
+
+    error = FTC_Manager_LookupSize( cache->manager, &attrs->scaler, &size );
+    if ( error )
+      goto Exit;
+
+    slot  = size->face->glyph;
+    error = FT_TS_Load_Glyph( size->face,
+                              gindex,
+                              ( (FT_TS_Int)attrs->load_flags   &
+                                  ~FT_TS_LOAD_RENDER         ) |
+                                FT_TS_LOAD_NO_BITMAP             );
+    if ( error )
+      goto Exit;
+
+    if ( slot->format != FT_TS_GLYPH_FORMAT_OUTLINE )
+    {
+      error = FT_TS_THROW( Invalid_Glyph_Format );
+      goto Exit;
+    }
+
+    /* the advance is stored in 16.16 format, as by `FT_TS_Get_Glyph' */
+    if ( slot->advance.x >=  0x8000L * 64 ||
+         slot->advance.x <= -0x8000L * 64 ||
+         slot->advance.y >=  0x8000L * 64 ||
+         slot->advance.y <= -0x8000L * 64 )
+    {
+      error = FT_TS_THROW( Invalid_Argument );
+      goto Exit;
+    }
+
+    /* stroke the outline in the glyph slot; no copy is needed */
+    FT_TS_Stroker_Set( stroker,
+                       attrs->radius,
+                       attrs->line_cap,
+                       attrs->line_join,
+                       attrs->miter_limit );
+
+    error = FT_TS_Stroker_ParseOutline( stroker, &slot->outline, FALSE );
+    if ( error )
+      goto Exit;
+
+    FT_TS_Stroker_GetCounts( stroker, &num_points, &num_contours );
+
+    error = FT_TS_New_Glyph( slot->library,
+                             FT_TS_GLYPH_FORMAT_OUTLINE,
+                             &glyph );
+    if ( error )
+      goto Exit;
+
+    glyph->advance.x = slot->advance.x * 1024;
+    glyph->advance.y = slot->advance.y * 1024;
+
+    outline = &( (FT_TS_OutlineGlyph)glyph )->outline;
+    error   = FT_TS_Outline_New( slot->library,
+                                 num_points,
+                                 (FT_TS_Int)num_contours,
+                                 outline );
+    if ( error )
+      goto Fail;
+
+    outline->n_points   = 0;
+    outline->n_contours = 0;
+
+    FT_TS_Stroker_Export( stroker, outline );
+
+    if ( attrs->load_flags & FT_TS_LOAD_RENDER )
+    {
+      error = FT_TS_Glyph_To_Bitmap(
+                &glyph,
+                FT_TS_LOAD_TARGET_MODE( attrs->load_flags ),
+                NULL,
+                1 );
+      if ( error )
+        goto Fail;
+    }
+
+    *aglyph = glyph;
+    goto Exit;
+
+  Fail:
+    FT_TS_Done_Glyph( glyph );
+
+  Exit:
+    return error;
+  }
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Bool )
+  ftc_stroke_gnode_compare_faceid( FTC_Node       ftcgnode,
+                                   FT_TS_Pointer  ftcface_id,
+                                   FTC_Cache      cache,
+                                   FT_TS_Bool*    list_changed )
+  {
+    FTC_GNode         gnode   = (FTC_GNode)ftcgnode;
+    FTC_FaceID        face_id = (FTC_FaceID)ftcface_id;
+    FTC_StrokeFamily  family  = (FTC_StrokeFamily)gnode->family;
+    FT_TS_Bool        result;
+
+
+    if ( list_changed )
+      *list_changed = FALSE;
+    result = FT_TS_BOOL( family->attrs.scaler.face_id == face_id );
+    if ( result )
+      FTC_GNode_UnselectFamily( gnode, cache );
+    return result;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                         STROKE CACHE                          *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  FT_TS_CALLBACK_DEF( FT_TS_Error )
+  ftc_stroke_cache_init( FTC_Cache  cache )
+  {
+    FT_TS_Error  error;
+
+
+    FTC_STROKE_CACHE( cache )->stroker = NULL;
+
+    error = ftc_gcache_init( cache );
+    if ( !error )
+      error = FT_TS_Stroker_New( cache->manager->library,
+                                 &FTC_STROKE_CACHE( cache )->stroker );
+
+    return error;
+  }
+
+
+  FT_TS_CALLBACK_DEF( void )
+  ftc_stroke_cache_done( FTC_Cache  cache )
+  {
+    ftc_gcache_done( cache );
+
+    FT_TS_Stroker_Done( FTC_STROKE_CACHE( cache )->stroker );
+    FTC_STROKE_CACHE( cache )->stroker = NULL;
+  }
+
+
+  static
+  const FTC_IFamilyClassRec  ftc_stroke_family_class =
+  {
+    {
+      sizeof ( FTC_StrokeFamilyRec ),
+
+      ftc_stroke_family_compare, /* FTC_MruNode_CompareFunc  node_compare */
+      ftc_stroke_family_init,    /* FTC_MruNode_InitFunc     node_init    */
+      NULL,                      /* FTC_MruNode_ResetFunc    node_reset   */
+      NULL                       /* FTC_MruNode_DoneFunc     node_done    */
+    },
+
+    ftc_stroke_family_load_glyph /* FTC_IFamily_LoadGlyphFunc  family_load_glyph */
+  };
+
+
+  static
+  const FTC_GCacheClassRec  ftc_stroke_cache_class =
+  {
+    {
+      ftc_inode_new,                   /* FTC_Node_NewFunc      node_new           */
+      ftc_inode_weight,                /* FTC_Node_WeightFunc   node_weight        */
+      ftc_gnode_compare,               /* FTC_Node_CompareFunc  node_compare       */
+      ftc_stroke_gnode_compare_faceid, /* FTC_Node_CompareFunc  node_remove_faceid */
+      ftc_inode_free,                  /* FTC_Node_FreeFunc     node_free          */
+
+      sizeof ( FTC_StrokeCacheRec ),
+      ftc_stroke_cache_init,           /* FTC_Cache_InitFunc    cache_init         */
+      ftc_stroke_cache_done            /* FTC_Cache_DoneFunc    cache_done         */
+    },
+
+    (FTC_MruListClass)&ftc_stroke_family_class
+  };
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_StrokeCache_New( FTC_Manager       manager,
+                       FTC_StrokeCache  *acache )
+  {
+    return FTC_GCache_New( manager, &ftc_stroke_cache_class,
+                           (FTC_GCache*)acache );
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_StrokeCache_Lookup( FTC_StrokeCache  cache,
+                          FTC_StrokeType   type,
+                          FT_TS_UInt       gindex,
+                          FT_TS_Glyph     *aglyph,
+                          FTC_Node        *anode )
+  {
+    FTC_StrokeQueryRec  query;
+    FTC_Node            node = 0; /* make compiler happy */
+    FT_TS_Error         error;
+    FT_TS_Offset        hash;
+
+
+    if ( anode )
+      *anode = NULL;
+
+    /* other argument checks delayed to `FTC_Cache_Lookup' */
+    if ( !aglyph || !type )
+      return FT_TS_THROW( Invalid_Argument );
+
+    *aglyph = NULL;
+
+    query.attrs.scaler.face_id = type->face_id;
+    query.attrs.scaler.width   = type->width;
+    query.attrs.scaler.height  = type->height;
+    query.attrs.scaler.pixel   = 1;
+    query.attrs.scaler.x_res   = 0;  /* make compilers happy */
+    query.attrs.scaler.y_res   = 0;
+    query.attrs.load_flags     = (FT_TS_UInt)type->flags;
+    query.attrs.radius         = type->radius;
+    query.attrs.line_cap       = type->line_cap;
+    query.attrs.line_join      = type->line_join;
+
+    /* the stroker ignores miter limits below 1 and for other joins */
+    query.attrs.miter_limit = type->miter_limit < 0x10000L
+                                ? 0x10000L
+                                : type->miter_limit;
+    if ( type->line_join == FT_TS_STROKER_LINEJOIN_ROUND ||
+         type->line_join == FT_TS_STROKER_LINEJOIN_BEVEL )
+      query.attrs.miter_limit = 0x10000L;
+
+    hash = FTC_STROKE_ATTR_HASH( &query.attrs ) + gindex;
+
+    FTC_GCACHE_LOOKUP_CMP( cache,
+                           ftc_stroke_family_compare,
+                           FTC_GNode_Compare,
+                           hash, gindex,
+                           &query,
+                           node,
+                           error );
+    if ( error )
+      goto Exit;
+
+    *aglyph = FTC_INODE( node )->glyph;
+
+    if ( anode )
+    {
+      *anode = node;
+      node->ref_count++;
+    }
+
+  Exit:
+    return error;
+  }
+
+
+/* END */
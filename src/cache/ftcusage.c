@@ -0,0 +1,783 @@
+/****************************************************************************
+ *
+ * ftcusage.c
+ *
+ *   FreeType Cache glyph usage profiles (body).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcache.h>
+#include "ftcusage.h"
+#include "ftcmanag.h"
+#include <freetype/internal/ftobjs.h>
+#include <freetype/internal/ftdebug.h>
+#include <freetype/internal/ftstream.h>
+
+#include "ftcerror.h"
+
+
+#undef  FT_TS_COMPONENT
+#define FT_TS_COMPONENT  cache
+
+
+  /*
+   * The serialized profile is a sequence of big-endian fields.
+   *
+   *   header:  `FTCU' tag, version (2 bytes), reserved (2 bytes),
+   *            number of groups (4 bytes)
+   *
+   *   group:   face key (4), kind (1), pixel (1), reserved (2),
+   *            width (4), height (4), x_res (4), y_res (4),
+   *            load flags (4), number of glyphs (4)
+   *
+   *   glyphs:  pairs of variable-length integers (7 bits per byte,
+   *            high bit set on all but the last byte) holding the glyph
+   *            index delta to the previous glyph of the group, and the
+   *            hit count; glyphs are sorted by increasing index
+   */
+
+#define FTC_USAGE_TAG         FT_TS_MAKE_TAG( 'F', 'T', 'C', 'U' )
+#define FTC_USAGE_VERSION     1
+
+#define FTC_USAGE_HEADER_SIZE  12
+#define FTC_USAGE_GROUP_SIZE   32
+
+  /* number of bits a variable-length integer can hold */
+#define FTC_USAGE_VARINT_BITS  ( FT_TS_SIZEOF_LONG * 8 )
+
+  /* initial number of glyph slots per group */
+#define FTC_USAGE_MIN_SLOTS    64
+
+#define FTC_USAGE_HASH( gindex )  ( (FT_TS_UInt)(gindex) * 2654435761UL )
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                          RECORDING                            *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  static void
+  ftc_usage_group_free( FTC_UsageGroup  group,
+                        FT_TS_Memory    memory )
+  {
+    FT_TS_FREE( group->slots );
+    FT_TS_FREE( group );
+  }
+
+
+  /* find the slot of `gindex', or the empty slot where it belongs */
+  static FTC_UsageSlot
+  ftc_usage_group_probe( FTC_UsageSlot  slots,
+                         FT_TS_UInt     num_slots,
+                         FT_TS_UInt     gindex )
+  {
+    FT_TS_UInt  mask = num_slots - 1;
+    FT_TS_UInt  idx  = FTC_USAGE_HASH( gindex ) & mask;
+
+
+    for (;;)
+    {
+      FTC_UsageSlot  slot = slots + idx;
+
+
+      if ( slot->gindex == gindex + 1 || slot->gindex == 0 )
+        return slot;
+
+      idx = ( idx + 1 ) & mask;
+    }
+  }
+
+
+  static FT_TS_Error
+  ftc_usage_group_grow( FTC_UsageGroup  group,
+                        FT_TS_Memory    memory )
+  {
+    FT_TS_Error    error;
+    FT_TS_UInt     old_count = group->num_slots;
+    FT_TS_UInt     new_count = old_count ? old_count * 2
+                                         : FTC_USAGE_MIN_SLOTS;
+    FTC_UsageSlot  old_slots = group->slots;
+    FTC_UsageSlot  new_slots;
+    FT_TS_UInt     nn;
+
+
+    if ( FT_TS_NEW_ARRAY( new_slots, new_count ) )
+      return error;
+
+    for ( nn = 0; nn < old_count; nn++ )
+    {
+      FTC_UsageSlot  src = old_slots + nn;
+
+
+      if ( src->gindex )
+        *ftc_usage_group_probe( new_slots,
+                                new_count,
+                                src->gindex - 1 ) = *src;
+    }
+
+    FT_TS_FREE( old_slots );
+
+    group->slots     = new_slots;
+    group->num_slots = new_count;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  FTC_Usage_Record( FTC_Usage   usage,
+                    FT_TS_UInt  kind,
+                    FTC_Scaler  scaler,
+                    FT_TS_UInt  load_flags,
+                    FT_TS_UInt  gindex )
+  {
+    FT_TS_Memory    memory = usage->memory;
+    FT_TS_Error     error;
+    FTC_UsageGroup  group;
+    FTC_UsageGroup* pgroup;
+    FTC_UsageSlot   slot;
+
+
+    pgroup = &usage->groups;
+    for (;;)
+    {
+      group = *pgroup;
+      if ( !group )
+        break;
+
+      if ( group->kind == kind                        &&
+           group->load_flags == load_flags            &&
+           FTC_SCALER_COMPARE( &group->scaler, scaler ) )
+      {
+        /* move to front */
+        if ( pgroup != &usage->groups )
+        {
+          *pgroup       = group->next;
+          group->next   = usage->groups;
+          usage->groups = group;
+        }
+        break;
+      }
+
+      pgroup = &group->next;
+    }
+
+    if ( !group )
+    {
+      if ( FT_TS_NEW( group ) )
+        return;
+
+      group->kind       = kind;
+      group->scaler     = scaler[0];
+      group->load_flags = load_flags;
+
+      if ( ftc_usage_group_grow( group, memory ) )
+      {
+        FT_TS_FREE( group );
+        return;
+      }
+
+      group->next   = usage->groups;
+      usage->groups = group;
+      usage->num_groups++;
+    }
+
+    /* keep the table at most half full */
+    if ( group->num_used >= group->num_slots / 2 &&
+         ftc_usage_group_grow( group, memory )   )
+      return;
+
+    slot = ftc_usage_group_probe( group->slots, group->num_slots, gindex );
+    if ( !slot->gindex )
+    {
+      slot->gindex = gindex + 1;
+      group->num_used++;
+    }
+
+    if ( slot->count < FT_TS_ULONG_MAX )
+      slot->count++;
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  FTC_Usage_RemoveFaceID( FTC_Usage   usage,
+                          FTC_FaceID  face_id )
+  {
+    FT_TS_Memory     memory = usage->memory;
+    FTC_UsageGroup*  pgroup = &usage->groups;
+
+
+    while ( *pgroup )
+    {
+      FTC_UsageGroup  group = *pgroup;
+
+
+      if ( group->scaler.face_id == face_id )
+      {
+        *pgroup = group->next;
+        ftc_usage_group_free( group, memory );
+        usage->num_groups--;
+      }
+      else
+        pgroup = &group->next;
+    }
+  }
+
+
+  FT_TS_LOCAL_DEF( void )
+  FTC_Usage_Free( FTC_Usage  usage )
+  {
+    FT_TS_Memory    memory;
+    FTC_UsageGroup  group;
+
+
+    if ( !usage )
+      return;
+
+    memory = usage->memory;
+    group  = usage->groups;
+
+    while ( group )
+    {
+      FTC_UsageGroup  next = group->next;
+
+
+      ftc_usage_group_free( group, memory );
+      group = next;
+    }
+
+    FT_TS_FREE( usage );
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_Manager_RecordUsage( FTC_Manager  manager,
+                           FT_TS_Bool   enable )
+  {
+    FT_TS_Error   error = FT_TS_Err_Ok;
+    FT_TS_Memory  memory;
+
+
+    if ( !manager )
+      return FT_TS_THROW( Invalid_Cache_Handle );
+
+    memory = manager->memory;
+
+    if ( !enable )
+    {
+      FTC_Usage_Free( manager->usage );
+      manager->usage = NULL;
+    }
+    else if ( !manager->usage )
+    {
+      FTC_Usage  usage;
+
+
+      if ( !FT_TS_NEW( usage ) )
+      {
+        usage->memory  = memory;
+        manager->usage = usage;
+      }
+    }
+
+    return error;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                        SERIALIZATION                          *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  typedef struct  FTC_UsageWriterRec_
+  {
+    FT_TS_Byte*  cursor;  /* NULL if we only count bytes */
+    FT_TS_ULong  length;
+
+  } FTC_UsageWriterRec, *FTC_UsageWriter;
+
+
+  static void
+  ftc_usage_put_byte( FTC_UsageWriter  writer,
+                      FT_TS_UInt       value )
+  {
+    if ( writer->cursor )
+      *writer->cursor++ = (FT_TS_Byte)value;
+
+    writer->length++;
+  }
+
+
+  static void
+  ftc_usage_put_ulong( FTC_UsageWriter  writer,
+                       FT_TS_ULong      value )
+  {
+    ftc_usage_put_byte( writer, (FT_TS_UInt)( value >> 24 ) & 0xFF );
+    ftc_usage_put_byte( writer, (FT_TS_UInt)( value >> 16 ) & 0xFF );
+    ftc_usage_put_byte( writer, (FT_TS_UInt)( value >>  8 ) & 0xFF );
+    ftc_usage_put_byte( writer, (FT_TS_UInt)( value       ) & 0xFF );
+  }
+
+
+  static void
+  ftc_usage_put_varint( FTC_UsageWriter  writer,
+                        FT_TS_ULong      value )
+  {
+    while ( value >= 0x80 )
+    {
+      ftc_usage_put_byte( writer, (FT_TS_UInt)( value & 0x7F ) | 0x80 );
+      value >>= 7;
+    }
+    ftc_usage_put_byte( writer, (FT_TS_UInt)value );
+  }
+
+
+  static FT_TS_Bool
+  ftc_usage_get_varint( FT_TS_Byte*  *pp,
+                        FT_TS_Byte*   limit,
+                        FT_TS_ULong  *avalue )
+  {
+    FT_TS_Byte*  p     = *pp;
+    FT_TS_ULong  value = 0;
+    FT_TS_UInt   shift = 0;
+
+
+    for (;;)
+    {
+      FT_TS_UInt  byte;
+
+
+      if ( p >= limit || shift >= FTC_USAGE_VARINT_BITS )
+        return FALSE;
+
+      byte = *p++;
+
+      /* reject bits that don't fit into `value' */
+      if ( shift > FTC_USAGE_VARINT_BITS - 7                   &&
+           ( byte & 0x7F ) >> ( FTC_USAGE_VARINT_BITS - shift ) )
+        return FALSE;
+
+      value |= (FT_TS_ULong)( byte & 0x7F ) << shift;
+      shift += 7;
+
+      if ( !( byte & 0x80 ) )
+        break;
+    }
+
+    *pp     = p;
+    *avalue = value;
+    return TRUE;
+  }
+
+
+  FT_TS_COMPARE_DEF( int )
+  ftc_usage_compare_gindex( const void*  a,
+                            const void*  b )
+  {
+    FT_TS_UInt  ga = ( (const FTC_UsageSlotRec*)a )->gindex;
+    FT_TS_UInt  gb = ( (const FTC_UsageSlotRec*)b )->gindex;
+
+
+    if ( ga < gb )
+      return -1;
+    if ( ga > gb )
+      return 1;
+    return 0;
+  }
+
+
+  static void
+  ftc_usage_write( FTC_Usage         usage,
+                   FTC_FaceID_ToKey  to_key,
+                   FT_TS_Pointer     key_data,
+                   FTC_UsageSlot     sorted,
+                   FTC_UsageWriter   writer )
+  {
+    FTC_UsageGroup  group;
+
+
+    ftc_usage_put_ulong( writer, FTC_USAGE_TAG );
+    ftc_usage_put_byte( writer, 0 );
+    ftc_usage_put_byte( writer, FTC_USAGE_VERSION );
+    ftc_usage_put_byte( writer, 0 );
+    ftc_usage_put_byte( writer, 0 );
+    ftc_usage_put_ulong( writer, usage->num_groups );
+
+    for ( group = usage->groups; group; group = group->next )
+    {
+      FTC_Scaler  scaler = &group->scaler;
+      FT_TS_UInt  prev   = 0;
+      FT_TS_UInt  count  = 0;
+      FT_TS_UInt  nn;
+
+
+      ftc_usage_put_ulong( writer, to_key( scaler->face_id, key_data ) );
+      ftc_usage_put_byte( writer, group->kind );
+      ftc_usage_put_byte( writer, scaler->pixel ? 1 : 0 );
+      ftc_usage_put_byte( writer, 0 );
+      ftc_usage_put_byte( writer, 0 );
+      ftc_usage_put_ulong( writer, scaler->width );
+      ftc_usage_put_ulong( writer, scaler->height );
+      ftc_usage_put_ulong( writer, scaler->x_res );
+      ftc_usage_put_ulong( writer, scaler->y_res );
+      ftc_usage_put_ulong( writer, group->load_flags );
+      ftc_usage_put_ulong( writer, group->num_used );
+
+      /* delta coding needs the glyphs in ascending order */
+      for ( nn = 0; nn < group->num_slots; nn++ )
+        if ( group->slots[nn].gindex )
+          sorted[count++] = group->slots[nn];
+
+      ft_qsort( sorted,
+                count,
+                sizeof ( FTC_UsageSlotRec ),
+                ftc_usage_compare_gindex );
+
+      for ( nn = 0; nn < count; nn++ )
+      {
+        ftc_usage_put_varint( writer, sorted[nn].gindex - 1 - prev );
+        ftc_usage_put_varint( writer, sorted[nn].count );
+        prev = sorted[nn].gindex - 1;
+      }
+    }
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_Manager_SaveUsage( FTC_Manager       manager,
+                         FTC_FaceID_ToKey  to_key,
+                         FT_TS_Pointer     key_data,
+                         FT_TS_Byte*       buffer,
+                         FT_TS_ULong*      length )
+  {
+    FT_TS_Error         error;
+    FT_TS_Memory        memory;
+    FTC_Usage           usage;
+    FTC_UsageGroup      group;
+    FTC_UsageSlot       sorted = NULL;
+    FT_TS_UInt          max_used = 0;
+    FTC_UsageWriterRec  writer;
+
+
+    if ( !manager )
+      return FT_TS_THROW( Invalid_Cache_Handle );
+
+    usage = manager->usage;
+    if ( !usage || !to_key || !length )
+      return FT_TS_THROW( Invalid_Argument );
+
+    memory = manager->memory;
+
+    for ( group = usage->groups; group; group = group->next )
+      if ( group->num_used > max_used )
+        max_used = group->num_used;
+
+    if ( FT_TS_QNEW_ARRAY( sorted, max_used ) )
+      return error;
+
+    /* compute the length first */
+    writer.cursor = NULL;
+    writer.length = 0;
+    ftc_usage_write( usage, to_key, key_data, sorted, &writer );
+
+    if ( buffer )
+    {
+      if ( *length < writer.length )
+      {
+        error = FT_TS_THROW( Array_Too_Large );
+        goto Exit;
+      }
+
+      writer.cursor = buffer;
+      writer.length = 0;
+      ftc_usage_write( usage, to_key, key_data, sorted, &writer );
+    }
+
+    *length = writer.length;
+
+  Exit:
+    FT_TS_FREE( sorted );
+    return error;
+  }
+
+
+  /*************************************************************************/
+  /*************************************************************************/
+  /*****                                                               *****/
+  /*****                           REPLAY                              *****/
+  /*****                                                               *****/
+  /*************************************************************************/
+  /*************************************************************************/
+
+
+  typedef struct  FTC_UsageReplayGroupRec_
+  {
+    FT_TS_UInt     kind;
+    FTC_ScalerRec  scaler;
+    FT_TS_ULong    load_flags;
+
+  } FTC_UsageReplayGroupRec, *FTC_UsageReplayGroup;
+
+
+  typedef struct  FTC_UsageReplayEntryRec_
+  {
+    FT_TS_UInt   group;
+    FT_TS_UInt   gindex;
+    FT_TS_ULong  count;
+
+  } FTC_UsageReplayEntryRec, *FTC_UsageReplayEntry;
+
+
+  FT_TS_COMPARE_DEF( int )
+  ftc_usage_compare_hotness( const void*  a,
+                             const void*  b )
+  {
+    const FTC_UsageReplayEntryRec*  ea = (const FTC_UsageReplayEntryRec*)a;
+    const FTC_UsageReplayEntryRec*  eb = (const FTC_UsageReplayEntryRec*)b;
+
+
+    if ( ea->count != eb->count )
+      return ea->count > eb->count ? -1 : 1;
+    if ( ea->group != eb->group )
+      return ea->group < eb->group ? -1 : 1;
+    if ( ea->gindex != eb->gindex )
+      return ea->gindex < eb->gindex ? -1 : 1;
+    return 0;
+  }
+
+
+  /* documentation is in ftcache.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FTC_Manager_Prewarm( FTC_Manager         manager,
+                       FTC_ImageCache      image_cache,
+                       FTC_SBitCache       sbit_cache,
+                       const FT_TS_Byte*   buffer,
+                       FT_TS_ULong         length,
+                       FTC_FaceID_FromKey  from_key,
+                       FT_TS_Pointer       key_data,
+                       FT_TS_UInt          max_glyphs,
+                       FT_TS_UInt         *acursor )
+  {
+    FT_TS_Error  error;
+    FT_TS_Memory memory;
+    FT_TS_Byte*  p     = (FT_TS_Byte*)buffer;
+    FT_TS_Byte*  limit = p + length;
+
+    FTC_UsageReplayGroup  groups  = NULL;
+    FTC_UsageReplayEntry  entries = NULL;
+    FT_TS_UInt            num_groups;
+    FT_TS_UInt            num_entries = 0;
+    FT_TS_UInt            cursor;
+    FT_TS_UInt            nn;
+    FTC_Usage             usage;
+
+
+    if ( !manager )
+      return FT_TS_THROW( Invalid_Cache_Handle );
+
+    if ( !buffer || length < FTC_USAGE_HEADER_SIZE )
+      return FT_TS_THROW( Invalid_Argument );
+
+    memory = manager->memory;
+    cursor = acursor ? *acursor : 0;
+
+    if ( FT_TS_NEXT_ULONG( p ) != FTC_USAGE_TAG ||
+         FT_TS_NEXT_USHORT( p ) != FTC_USAGE_VERSION )
+      return FT_TS_THROW( Invalid_File_Format );
+
+    p         += 2;
+    num_groups = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+
+    if ( num_groups > (FT_TS_ULong)( limit - p ) / FTC_USAGE_GROUP_SIZE )
+      return FT_TS_THROW( Invalid_Table );
+
+    if ( FT_TS_NEW_ARRAY( groups, num_groups ) )
+      goto Exit;
+
+    /* first pass: read group headers and count glyphs */
+    {
+      FT_TS_Byte*  q = p;
+
+
+      for ( nn = 0; nn < num_groups; nn++ )
+      {
+        FT_TS_ULong  count, mm;
+
+
+        if ( limit - q < FTC_USAGE_GROUP_SIZE )
+          goto Invalid;
+
+        q     += FTC_USAGE_GROUP_SIZE - 4;
+        count  = FT_TS_NEXT_ULONG( q );
+
+        for ( mm = 0; mm < count; mm++ )
+        {
+          FT_TS_ULong  dummy;
+
+
+          if ( !ftc_usage_get_varint( &q, limit, &dummy ) ||
+               !ftc_usage_get_varint( &q, limit, &dummy ) )
+            goto Invalid;
+        }
+
+        if ( count > FT_TS_UINT_MAX - num_entries )
+          goto Invalid;
+
+        num_entries += (FT_TS_UInt)count;
+      }
+    }
+
+    if ( cursor >= num_entries )
+      goto Exit;
+
+    if ( FT_TS_QNEW_ARRAY( entries, num_entries ) )
+      goto Exit;
+
+    /* second pass: resolve faces and collect the glyph entries */
+    num_entries = 0;
+
+    for ( nn = 0; nn < num_groups; nn++ )
+    {
+      FTC_UsageReplayGroup  group = groups + nn;
+      FT_TS_ULong           key, count, mm;
+      FT_TS_ULong           gindex = 0;
+
+
+      key                  = FT_TS_NEXT_ULONG( p );
+      group->kind          = FT_TS_NEXT_BYTE( p );
+      group->scaler.pixel  = FT_TS_NEXT_BYTE( p );
+      p                   += 2;
+      group->scaler.width  = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+      group->scaler.height = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+      group->scaler.x_res  = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+      group->scaler.y_res  = (FT_TS_UInt)FT_TS_NEXT_ULONG( p );
+      group->load_flags    = FT_TS_NEXT_ULONG( p );
+      count                = FT_TS_NEXT_ULONG( p );
+
+      if ( from_key )
+        group->scaler.face_id = from_key( key, key_data );
+      else
+        group->scaler.face_id = (FTC_FaceID)(FT_TS_Offset)key;
+
+      for ( mm = 0; mm < count; mm++ )
+      {
+        FT_TS_ULong  delta = 0;
+        FT_TS_ULong  hits  = 0;
+
+
+        /* already validated in the first pass */
+        (void)ftc_usage_get_varint( &p, limit, &delta );
+        (void)ftc_usage_get_varint( &p, limit, &hits );
+
+        gindex += delta;
+
+        /* drop glyphs of faces the client can't provide any more */
+        if ( !group->scaler.face_id || gindex > FT_TS_UINT_MAX )
+          continue;
+
+        entries[num_entries].group  = nn;
+        entries[num_entries].gindex = (FT_TS_UInt)gindex;
+        entries[num_entries].count  = hits;
+        num_entries++;
+      }
+    }
+
+    ft_qsort( entries,
+              num_entries,
+              sizeof ( FTC_UsageReplayEntryRec ),
+              ftc_usage_compare_hotness );
+
+    /* don't let the replay show up in a running recording */
+    usage          = manager->usage;
+    manager->usage = NULL;
+
+    for ( nn = 0;
+          cursor < num_entries && ( !max_glyphs || nn < max_glyphs );
+          cursor++, nn++ )
+    {
+      FTC_UsageReplayEntry  entry = entries + cursor;
+      FTC_UsageReplayGroup  group = groups + entry->group;
+      FT_TS_Error           err   = FT_TS_Err_Ok;
+
+
+      /* stop as soon as the cache is full; loading colder glyphs */
+      /* would only evict the hotter ones we just loaded          */
+      if ( manager->cur_weight >= manager->max_weight )
+      {
+        cursor = num_entries;
+        break;
+      }
+
+      if ( group->kind == FTC_USAGE_KIND_IMAGE && image_cache )
+      {
+        FT_TS_Glyph  glyph;
+
+
+        err = FTC_ImageCache_LookupScaler( image_cache,
+                                           &group->scaler,
+                                           group->load_flags,
+                                           entry->gindex,
+                                           &glyph,
+                                           NULL );
+      }
+      else if ( group->kind == FTC_USAGE_KIND_SBIT && sbit_cache )
+      {
+        FTC_SBit  sbit;
+
+
+        err = FTC_SBitCache_LookupScaler( sbit_cache,
+                                          &group->scaler,
+                                          group->load_flags,
+                                          entry->gindex,
+                                          &sbit,
+                                          NULL );
+      }
+
+      /* a glyph that can't be loaded shouldn't stop the replay */
+      if ( err )
+        FT_TS_TRACE1(( "FTC_Manager_Prewarm:"
+                       " cannot load glyph %d (error 0x%x)\n",
+                       entry->gindex, err ));
+    }
+
+    manager->usage = usage;
+    goto Exit;
+
+  Invalid:
+    error = FT_TS_THROW( Invalid_Table );
+
+  Exit:
+    if ( acursor && !error )
+      *acursor = cursor;
+
+    FT_TS_FREE( entries );
+    FT_TS_FREE( groups );
+
+    return error;
+  }
+
+
+/* END */
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ * ftcusage.h
+ *
+ *   FreeType Cache glyph usage profiles (specification).
+ *
+ * Copyright (C) 2000-2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+  /**************************************************************************
+   *
+   * A usage profile is a histogram of the glyphs requested from the image
+   * and sbit caches of a given manager.  Glyphs are grouped by `kind'
+   * (image or sbit cache), scaler, and load flags; within a group, each
+   * glyph index is mapped to a hit counter by a small open-addressed hash
+   * table.
+   *
+   * Groups are kept in a list that is reordered on each hit, so that the
+   * common case of text rendered with a single face and size only costs a
+   * pointer comparison plus one hash probe per cache lookup.
+   *
+   */
+
+
+#ifndef FTCUSAGE_H_
+#define FTCUSAGE_H_
+
+
+#include <freetype/ftcache.h>
+
+
+FT_TS_BEGIN_HEADER
+
+
+#define FTC_USAGE_KIND_IMAGE  0
+#define FTC_USAGE_KIND_SBIT   1
+
+
+  typedef struct  FTC_UsageSlotRec_
+  {
+    FT_TS_UInt   gindex;   /* glyph index plus one, 0 for empty slots */
+    FT_TS_ULong  count;
+
+  } FTC_UsageSlotRec, *FTC_UsageSlot;
+
+
+  typedef struct FTC_UsageGroupRec_*  FTC_UsageGroup;
+
+  typedef struct  FTC_UsageGroupRec_
+  {
+    FTC_UsageGroup  next;
+
+    FT_TS_UInt      kind;
+    FTC_ScalerRec   scaler;
+    FT_TS_UInt      load_flags;
+
+    FT_TS_UInt      num_slots;  /* a power of 2 */
+    FT_TS_UInt      num_used;
+    FTC_UsageSlot   slots;
+
+  } FTC_UsageGroupRec;
+
+
+  typedef struct  FTC_UsageRec_
+  {
+    FT_TS_Memory    memory;
+    FTC_UsageGroup  groups;
+    FT_TS_UInt      num_groups;
+
+  } FTC_UsageRec, *FTC_Usage;
+
+
+  /* count one request of glyph `gindex'; a no-op if `usage' is NULL */
+  FT_TS_LOCAL( void )
+  FTC_Usage_Record( FTC_Usage   usage,
+                    FT_TS_UInt  kind,
+                    FTC_Scaler  scaler,
+                    FT_TS_UInt  load_flags,
+                    FT_TS_UInt  gindex );
+
+  /* forget all groups that refer to `face_id' */
+  FT_TS_LOCAL( void )
+  FTC_Usage_RemoveFaceID( FTC_Usage   usage,
+                          FTC_FaceID  face_id );
+
+  FT_TS_LOCAL( void )
+  FTC_Usage_Free( FTC_Usage  usage );
+
+
+#define FTC_USAGE_RECORD( manager, kind, scaler, load_flags, gindex ) \
+  FT_TS_BEGIN_STMNT                                                   \
+    if ( (manager)->usage )                                           \
+      FTC_Usage_Record( (manager)->usage, kind,                       \
+                        scaler, load_flags, gindex );                 \
+  FT_TS_END_STMNT
+
+
+FT_TS_END_HEADER
+
+#endif /* FTCUSAGE_H_ */
+
+
+/* END */
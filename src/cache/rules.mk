@@ -28,14 +28,18 @@ CACHE_COMPILE := $(CC) $(ANSIFLAGS)                              \
 
 # Cache driver sources (i.e., C files)
 #
-CACHE_DRV_SRC := $(CACHE_DIR)/ftcbasic.c \
-                 $(CACHE_DIR)/ftccache.c \
-                 $(CACHE_DIR)/ftccmap.c  \
-                 $(CACHE_DIR)/ftcglyph.c \
-                 $(CACHE_DIR)/ftcimage.c \
-                 $(CACHE_DIR)/ftcmanag.c \
-                 $(CACHE_DIR)/ftcmru.c   \
-                 $(CACHE_DIR)/ftcsbits.c
+CACHE_DRV_SRC := $(CACHE_DIR)/ftcbasic.c  \
+                 $(CACHE_DIR)/ftccache.c  \
+                 $(CACHE_DIR)/ftccmap.c   \
+                 $(CACHE_DIR)/ftcglyph.c  \
+                 $(CACHE_DIR)/ftcimage.c  \
+                 $(CACHE_DIR)/ftcmanag.c  \
+                 $(CACHE_DIR)/ftcmru.c    \
+                 $(CACHE_DIR)/ftcsbits.c  \
+                 $(CACHE_DIR)/ftcsdf.c    \
+                 $(CACHE_DIR)/ftcshare.c  \
+                 $(CACHE_DIR)/ftcstroke.c \
+                 $(CACHE_DIR)/ftcusage.c
 
 
 # Cache driver headers
@@ -47,7 +51,9 @@ CACHE_DRV_H := $(CACHE_DIR)/ftccache.h \
                $(CACHE_DIR)/ftcimage.h \
                $(CACHE_DIR)/ftcmanag.h \
                $(CACHE_DIR)/ftcmru.h   \
-               $(CACHE_DIR)/ftcsbits.h
+               $(CACHE_DIR)/ftcsbits.h \
+               $(CACHE_DIR)/ftcshare.h \
+               $(CACHE_DIR)/ftcusage.h
 
 
 # Cache driver object(s)
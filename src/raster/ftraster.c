@@ -150,6 +150,16 @@
   /*************************************************************************/
 
 
+  /**************************************************************************
+   *
+   * The minimum number of bytes of a span's interior for which
+   * `Vertical_Sweep_Span' uses `memset' instead of a byte loop.
+   */
+#ifndef RASTER_SPAN_MEMSET
+#define RASTER_SPAN_MEMSET  16
+#endif
+
+
   /*************************************************************************/
   /*************************************************************************/
   /**                                                                     **/
@@ -2061,11 +2071,15 @@
    *
    * InsNew
    *
-   *   Inserts a new profile in a linked list.
+   *   Inserts a chain of new profiles, from `first' to `last', in a linked
+   *   list.  All profiles of the chain must have the same X coordinate;
+   *   they are inserted in order after the profiles with a smaller or
+   *   equal X coordinate, exactly as if they were inserted one by one.
    */
   static void
   InsNew( PProfileList  list,
-          PProfile      profile )
+          PProfile      first,
+          PProfile      last )
   {
     PProfile  *old, current;
     Long       x;
@@ -2073,7 +2087,7 @@
 
     old     = list;
     current = *old;
-    x       = profile->X;
+    x       = first->X;
 
     while ( current )
     {
@@ -2083,41 +2097,8 @@
       current = *old;
     }
 
-    profile->link = current;
-    *old          = profile;
-  }
-
-
-  /**************************************************************************
-   *
-   * DelOld
-   *
-   *   Removes an old profile from a linked list.
-   */
-  static void
-  DelOld( PProfileList    list,
-          const PProfile  profile )
-  {
-    PProfile  *old, current;
-
-
-    old     = list;
-    current = *old;
-
-    while ( current )
-    {
-      if ( current == profile )
-      {
-        *old = current->link;
-        return;
-      }
-
-      old     = &current->link;
-      current = *old;
-    }
-
-    /* we should never get there, unless the profile was not part of */
-    /* the list.                                                     */
+    last->link = current;
+    *old       = first;
   }
 
 
@@ -2126,52 +2107,62 @@
    * Sort
    *
    *   Sorts a trace list.  In 95%, the list is already sorted.  We need
-   *   an algorithm which is fast in this case.  Bubble sort is enough
-   *   and simple.
+   *   an algorithm which is fast in this case; we thus check the order
+   *   while updating the X coordinates and only sort if necessary.  Out
+   *   of order profiles are then moved back in a single insertion pass,
+   *   which is stable like the bubble sort used earlier but doesn't
+   *   restart from the list head after each swap.
    */
   static void
   Sort( PProfileList  list )
   {
     PProfile  *old, current, next;
+    Long       x;
+    Bool       sorted = TRUE;
 
 
-    /* First, set the new X coordinate of each profile */
     current = *list;
+    if ( !current )
+      return;
+
+    /* First, set the new X coordinate of each profile */
+    x = *current->offset;
+
     while ( current )
     {
-      current->X       = *current->offset;
+      if ( *current->offset < x )
+        sorted = FALSE;
+
+      x                = *current->offset;
+      current->X       = x;
       current->offset += ( current->flags & Flow_Up ) ? 1 : -1;
       current->height--;
       current = current->link;
     }
 
-    /* Then sort them */
-    old     = list;
-    current = *old;
-
-    if ( !current )
+    if ( sorted )
       return;
 
-    next = current->link;
+    /* Then sort them */
+    current = *list;
+    next    = current->link;
 
     while ( next )
     {
       if ( current->X <= next->X )
-      {
-        old     = &current->link;
-        current = *old;
-
-        if ( !current )
-          return;
-      }
+        current = next;
       else
       {
-        *old          = next;
+        /* unlink `next' and move it behind the last profile of the */
+        /* sorted part that is not greater                          */
         current->link = next->link;
-        next->link    = current;
 
-        old     = list;
-        current = *old;
+        old = list;
+        while ( ( *old )->X <= next->X )
+          old = &( *old )->link;
+
+        next->link = *old;
+        *old       = next;
       }
 
       next = current->link;
@@ -2265,11 +2256,18 @@
       {
         target[0] |= f1;
 
-        /* memset() is slower than the following code on many platforms. */
-        /* This is due to the fact that, in the vast majority of cases,  */
-        /* the span length in bytes is relatively small.                 */
-        while ( --c2 > 0 )
-          *( ++target ) = 0xFF;
+        /* memset() is slower than the following code on many platforms */
+        /* for short spans, which are the vast majority of cases.  Long */
+        /* spans of large glyphs, however, benefit from the word-wide   */
+        /* stores of the C library.                                     */
+        if ( c2 > RASTER_SPAN_MEMSET )
+        {
+          FT_TS_MEM_SET( target + 1, 0xFF, c2 - 1 );
+          target += c2 - 1;
+        }
+        else
+          while ( --c2 > 0 )
+            *( ++target ) = 0xFF;
 
         target[1] |= f2;
       }
@@ -2679,13 +2677,17 @@
 
     Long          x1, x2, xs, e1, e2;
 
+    PProfile     *old;
+    PProfile      new_left, new_right, last_left, last_right;
+
     TProfileList  waiting;
     TProfileList  draw_left, draw_right;
 
 
-    /* initialize empty linked lists */
+    /* initialize empty linked lists; the waiting list */
+    /* is the list of all profiles in creation order   */
 
-    Init_Linked( &waiting );
+    waiting = ras.fProfile;
 
     Init_Linked( &draw_left  );
     Init_Linked( &draw_right );
@@ -2698,8 +2700,6 @@
 
     while ( P )
     {
-      Q = P->link;
-
       bottom = (Short)P->start;
       top    = (Short)( P->start + P->height - 1 );
 
@@ -2709,9 +2709,8 @@
         max_Y = top;
 
       P->X = 0;
-      InsNew( &waiting, P );
 
-      P = Q;
+      P = P->link;
     }
 
     /* check the Y-turns */
@@ -2746,9 +2745,17 @@
 
     while ( ras.numTurns > 0 )
     {
-      /* check waiting list for new activations */
+      /* check waiting list for new activations; they are collected */
+      /* and then inserted into the drawing lists all at once        */
+
+      new_left  = NULL;
+      new_right = NULL;
+
+      last_left  = NULL;
+      last_right = NULL;
 
-      P = waiting;
+      old = &waiting;
+      P   = waiting;
 
       while ( P )
       {
@@ -2756,17 +2763,36 @@
         P->countL -= y_height;
         if ( P->countL == 0 )
         {
-          DelOld( &waiting, P );
+          *old = Q;
 
           if ( P->flags & Flow_Up )
-            InsNew( &draw_left,  P );
+          {
+            if ( last_left )
+              last_left->link = P;
+            else
+              new_left = P;
+            last_left = P;
+          }
           else
-            InsNew( &draw_right, P );
+          {
+            if ( last_right )
+              last_right->link = P;
+            else
+              new_right = P;
+            last_right = P;
+          }
         }
+        else
+          old = &P->link;
 
         P = Q;
       }
 
+      if ( new_left )
+        InsNew( &draw_left, new_left, last_left );
+      if ( new_right )
+        InsNew( &draw_right, new_right, last_right );
+
       /* sort the drawing lists */
 
       Sort( &draw_left );
@@ -2807,7 +2833,9 @@
               Int  dropOutControl = P_Left->flags & 7;
 
 
-              if ( dropOutControl != 2 )
+              /* modes 2, 3, 6, and 7 (bit 1 set) have no drop-out  */
+              /* control, thus `Proc_Sweep_Drop' would do nothing  */
+              if ( !( dropOutControl & 2 ) )
               {
                 /* a drop-out was detected */
 
@@ -2852,22 +2880,22 @@
 
       /* now finalize the profiles that need it */
 
-      P = draw_left;
-      while ( P )
+      old = &draw_left;
+      while ( ( P = *old ) != NULL )
       {
-        Q = P->link;
         if ( P->height == 0 )
-          DelOld( &draw_left, P );
-        P = Q;
+          *old = P->link;
+        else
+          old = &P->link;
       }
 
-      P = draw_right;
-      while ( P )
+      old = &draw_right;
+      while ( ( P = *old ) != NULL )
       {
-        Q = P->link;
         if ( P->height == 0 )
-          DelOld( &draw_right, P );
-        P = Q;
+          *old = P->link;
+        else
+          old = &P->link;
       }
     }
 
@@ -3251,9 +3279,11 @@
            outline->contours[outline->n_contours - 1] + 1 )
       return FT_TS_THROW( Invalid_Outline );
 
-    /* this version of the raster does not support direct rendering, sorry */
-    if ( params->flags & FT_TS_RASTER_FLAG_DIRECT ||
-         params->flags & FT_TS_RASTER_FLAG_AA     )
+    /* this version of the raster does not support direct rendering */
+    /* or transformation on the fly, sorry                          */
+    if ( params->flags & FT_TS_RASTER_FLAG_DIRECT    ||
+         params->flags & FT_TS_RASTER_FLAG_AA        ||
+         params->flags & FT_TS_RASTER_FLAG_TRANSFORM )
       return FT_TS_THROW( Cannot_Render_Glyph );
 
     if ( !target_map )
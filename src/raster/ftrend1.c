@@ -64,11 +64,7 @@
       goto Exit;
     }
 
-    if ( matrix )
-      FT_TS_Outline_Transform( &slot->outline, matrix );
-
-    if ( delta )
-      FT_TS_Outline_Translate( &slot->outline, delta->x, delta->y );
+    FT_TS_Outline_Transform_Translate( &slot->outline, matrix, delta );
 
   Exit:
     return error;
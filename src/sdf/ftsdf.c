@@ -27,6 +27,10 @@
 
 #include "ftsdferrs.h"
 
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+#include <pthread.h>
+#endif
+
 
   /**************************************************************************
    *
@@ -445,6 +449,10 @@
    *     that behaviour.  For example, while generating SDF for a single
    *     counter-clockwise contour, the outside sign should be 1.
    *
+   *   threads ::
+   *     The maximum number of threads to use in the bounding box
+   *     optimization.
+   *
    */
   typedef struct SDF_Params_
   {
@@ -453,6 +461,7 @@
     FT_TS_Bool         flip_y;
 
     FT_TS_Int  overload_sign;
+    FT_TS_UInt threads;
 
   } SDF_Params;
 
@@ -3194,6 +3203,229 @@
 #endif /* 0 */
 
 
+  /* the number of grid rows in a block handed out to a thread */
+#define SDF_BLOCK_ROWS  16
+
+  /* grids with fewer pixels are always done by the calling thread */
+#define SDF_MIN_THREAD_PIXELS  4096
+
+
+  /**************************************************************************
+   *
+   * @Struct:
+   *   SDF_Rows_Job
+   *
+   * @Description:
+   *   The state shared by all threads running `sdf_generate_bounding_box`.
+   *   The grid is split into blocks of `SDF_BLOCK_ROWS` rows, which are
+   *   handed out in turn; each block is computed against the edges whose
+   *   boxes reach it, in the order of the shape, so that the result does
+   *   not depend on the number of threads.
+   *
+   */
+  typedef struct  SDF_Rows_Job_
+  {
+    SDF_Params            params;
+    SDF_Edge**            edges;       /* all edges of the shape         */
+    FT_TS_CBox*           cboxes;      /* their pixel boxes with spread  */
+    FT_TS_UInt            num_edges;
+
+    SDF_Signed_Distance*  dists;
+    FT_TS_SDFFormat*      buffer;
+    FT_TS_Int             width;
+    FT_TS_Int             rows;
+    FT_TS_16D16           sp_sq;
+    FT_TS_16D16           fixed_spread;
+
+    FT_TS_Int             num_blocks;
+    FT_TS_Int             next_block;  /* the next block to hand out     */
+    FT_TS_Error           error;       /* the first error of any thread  */
+
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+    pthread_mutex_t       lock;        /* protects the two fields above  */
+#endif
+
+  } SDF_Rows_Job;
+
+
+  /* Compute grid rows `y_min` to `y_max - 1` (from the bottom). */
+  static FT_TS_Error
+  sdf_generate_rows( SDF_Rows_Job*  job,
+                     FT_TS_Int      y_min,
+                     FT_TS_Int      y_max )
+  {
+    FT_TS_Error  error = FT_TS_Err_Ok;
+
+    FT_TS_Int  width = job->width;
+    FT_TS_Int  rows  = job->rows;
+    FT_TS_Int  i, y;
+    FT_TS_UInt e;
+
+    SDF_Signed_Distance*  dists = job->dists;
+
+
+    /* loop over all edges reaching the block */
+    for ( e = 0; e < job->num_edges; e++ )
+    {
+      FT_TS_CBox*  cbox = job->cboxes + e;
+      FT_TS_Int    x0, x1, y0, y1;
+
+
+      if ( cbox->yMax <= y_min || cbox->yMin >= y_max )
+        continue;
+
+      x0 = (FT_TS_Int)FT_TS_MAX( cbox->xMin, 0 );
+      x1 = (FT_TS_Int)FT_TS_MIN( cbox->xMax, width );
+      y0 = (FT_TS_Int)FT_TS_MAX( cbox->yMin, y_min );
+      y1 = (FT_TS_Int)FT_TS_MIN( cbox->yMax, y_max );
+
+      /* now loop over the pixels in the control box */
+      for ( y = y0; y < y1; y++ )
+      {
+        FT_TS_Int  x;
+
+
+        for ( x = x0; x < x1; x++ )
+        {
+          FT_TS_26D6_Vec          grid_point = zero_vector;
+          SDF_Signed_Distance  dist       = max_sdf;
+          FT_TS_UInt              index      = 0;
+          FT_TS_16D16             diff       = 0;
+
+
+          grid_point.x = FT_TS_INT_26D6( x );
+          grid_point.y = FT_TS_INT_26D6( y );
+
+          /* This `grid_point` is at the corner, but we */
+          /* use the center of the pixel.               */
+          grid_point.x += FT_TS_INT_26D6( 1 ) / 2;
+          grid_point.y += FT_TS_INT_26D6( 1 ) / 2;
+
+          FT_TS_CALL( sdf_edge_get_min_distance( job->edges[e],
+                                              grid_point,
+                                              &dist ) );
+
+          if ( job->params.orientation == FT_TS_ORIENTATION_FILL_LEFT )
+            dist.sign = -dist.sign;
+
+          /* ignore if the distance is greater than spread;       */
+          /* otherwise it creates artifacts due to the wrong sign */
+          if ( dist.distance > job->sp_sq )
+            continue;
+
+          /* take the square root of the distance if required */
+          if ( USE_SQUARED_DISTANCES )
+            dist.distance = square_root( dist.distance );
+
+          if ( job->params.flip_y )
+            index = (FT_TS_UInt)( y * width + x );
+          else
+            index = (FT_TS_UInt)( ( rows - y - 1 ) * width + x );
+
+          /* check whether the pixel is set or not */
+          if ( dists[index].sign == 0 )
+            dists[index] = dist;
+          else
+          {
+            diff = FT_TS_ABS( dists[index].distance - dist.distance );
+
+            if ( diff <= CORNER_CHECK_EPSILON )
+              dists[index] = resolve_corner( dists[index], dist );
+            else if ( dists[index].distance > dist.distance )
+              dists[index] = dist;
+          }
+        }
+      }
+    }
+
+    /* final pass over the bitmap rows of the block */
+    for ( y = y_min; y < y_max; y++ )
+    {
+      FT_TS_Int  j = job->params.flip_y ? y : rows - y - 1;
+
+      /* We assume the starting pixel of each row is outside. */
+      FT_TS_Char  current_sign = -1;
+      FT_TS_UInt  index;
+
+
+      if ( job->params.overload_sign != 0 )
+        current_sign = job->params.overload_sign < 0 ? -1 : 1;
+
+      for ( i = 0; i < width; i++ )
+      {
+        index = (FT_TS_UInt)( j * width + i );
+
+        /* if the pixel is not set                     */
+        /* its shortest distance is more than `spread` */
+        if ( dists[index].sign == 0 )
+          dists[index].distance = job->fixed_spread;
+        else
+          current_sign = dists[index].sign;
+
+        /* clamp the values */
+        if ( dists[index].distance > job->fixed_spread )
+          dists[index].distance = job->fixed_spread;
+
+        /* flip sign if required */
+        dists[index].distance *= job->params.flip_sign ? -current_sign
+                                                       :  current_sign;
+
+        /* concatenate to appropriate format */
+        job->buffer[index] = map_fixed_to_sdf( dists[index].distance,
+                                               job->fixed_spread );
+      }
+    }
+
+  Exit:
+    return error;
+  }
+
+
+  /* Compute blocks until none is left or any thread fails. */
+  static void*
+  sdf_rows_worker( void*  arg )
+  {
+    SDF_Rows_Job*  job = (SDF_Rows_Job*)arg;
+
+
+    for (;;)
+    {
+      FT_TS_Int    block;
+      FT_TS_Error  error;
+
+
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+      pthread_mutex_lock( &job->lock );
+#endif
+      block = job->error ? job->num_blocks : job->next_block++;
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+      pthread_mutex_unlock( &job->lock );
+#endif
+
+      if ( block >= job->num_blocks )
+        break;
+
+      error = sdf_generate_rows( job,
+                                 block * SDF_BLOCK_ROWS,
+                                 FT_TS_MIN( ( block + 1 ) * SDF_BLOCK_ROWS,
+                                            job->rows ) );
+      if ( error )
+      {
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+        pthread_mutex_lock( &job->lock );
+#endif
+        if ( !job->error )
+          job->error = error;
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+        pthread_mutex_unlock( &job->lock );
+#endif
+      }
+    }
+
+    return NULL;
+  }
+
+
   /**************************************************************************
    *
    * @Function:
@@ -3215,6 +3447,10 @@
    *   of overflow because we only check the proximity of the curve.
    *   Therefore we can use squared distanced safely.
    *
+   *   The grid is processed in blocks of rows (see @SDF_Rows_Job), which
+   *   are distributed over up to `internal_params.threads` threads if
+   *   `FT_TS_CONFIG_OPTION_SDF_THREADS` is defined.
+   *
    * @Input:
    *   internal_params ::
    *     Internal parameters and properties required by the rasterizer.
@@ -3243,21 +3479,22 @@
     FT_TS_Error   error  = FT_TS_Err_Ok;
     FT_TS_Memory  memory = NULL;
 
-    FT_TS_Int  width, rows, i, j;
-    FT_TS_Int  sp_sq;            /* max value to check   */
+    SDF_Contour*  contours;  /* list of all contours */
+    SDF_Edge*     edges;
+    SDF_Rows_Job  job;
+    FT_TS_UInt    num_threads;
+
+    const FT_TS_16D16  fixed_spread = FT_TS_INT_16D16( spread );
 
-    SDF_Contour*   contours;  /* list of all contours */
-    FT_TS_SDFFormat*  buffer;    /* the bitmap buffer    */
 
     /* This buffer has the same size in indices as the    */
     /* bitmap buffer.  When we check a pixel position for */
     /* a shortest distance we keep it in this buffer.     */
     /* This way we can find out which pixel is set,       */
     /* and also determine the signs properly.             */
-    SDF_Signed_Distance*  dists = NULL;
-
-    const FT_TS_16D16  fixed_spread = FT_TS_INT_16D16( spread );
-
+    job.dists  = NULL;
+    job.edges  = NULL;
+    job.cboxes = NULL;
 
     if ( !shape || !bitmap )
     {
@@ -3278,156 +3515,118 @@
       goto Exit;
     }
 
-    if ( FT_TS_ALLOC( dists,
-                   bitmap->width * bitmap->rows * sizeof ( *dists ) ) )
-      goto Exit;
-
-    contours = shape->contours;
-    width    = (FT_TS_Int)bitmap->width;
-    rows     = (FT_TS_Int)bitmap->rows;
-    buffer   = (FT_TS_SDFFormat*)bitmap->buffer;
+    job.params       = internal_params;
+    job.width        = (FT_TS_Int)bitmap->width;
+    job.rows         = (FT_TS_Int)bitmap->rows;
+    job.buffer       = (FT_TS_SDFFormat*)bitmap->buffer;
+    job.fixed_spread = fixed_spread;
+    job.num_edges    = 0;
+    job.next_block   = 0;
+    job.error        = FT_TS_Err_Ok;
 
     if ( USE_SQUARED_DISTANCES )
-      sp_sq = FT_TS_INT_16D16( (FT_TS_Int)( spread * spread ) );
+      job.sp_sq = FT_TS_INT_16D16( (FT_TS_Int)( spread * spread ) );
     else
-      sp_sq = fixed_spread;
+      job.sp_sq = fixed_spread;
 
-    if ( width == 0 || rows == 0 )
+    if ( job.width == 0 || job.rows == 0 )
     {
       FT_TS_TRACE0(( "sdf_generate:"
                   " Cannot render glyph with width/height == 0\n" ));
       FT_TS_TRACE0(( "             "
-                  " (width, height provided [%d, %d])", width, rows ));
+                  " (width, height provided [%d, %d])",
+                  job.width, job.rows ));
 
       error = FT_TS_THROW( Cannot_Render_Glyph );
       goto Exit;
     }
 
-    /* loop over all contours */
-    while ( contours )
-    {
-      SDF_Edge*  edges = contours->edges;
+    if ( FT_TS_ALLOC( job.dists,
+                   bitmap->width * bitmap->rows * sizeof ( *job.dists ) ) )
+      goto Exit;
 
+    /* collect the edges and their control boxes, */
+    /* increased by `spread` and rounded to pixels */
+    for ( contours = shape->contours; contours; contours = contours->next )
+      for ( edges = contours->edges; edges; edges = edges->next )
+        job.num_edges++;
 
-      /* loop over all edges */
-      while ( edges )
-      {
-        FT_TS_CBox  cbox;
-        FT_TS_Int   x, y;
+    if ( FT_TS_QNEW_ARRAY( job.edges, job.num_edges )  ||
+         FT_TS_QNEW_ARRAY( job.cboxes, job.num_edges ) )
+      goto Exit;
 
+    job.num_edges = 0;
+    for ( contours = shape->contours; contours; contours = contours->next )
+    {
+      for ( edges = contours->edges; edges; edges = edges->next )
+      {
+        FT_TS_CBox  cbox = get_control_box( *edges );
 
-        /* get the control box and increase it by `spread' */
-        cbox = get_control_box( *edges );
 
         cbox.xMin = ( cbox.xMin - 63 ) / 64 - ( FT_TS_Pos )spread;
         cbox.xMax = ( cbox.xMax + 63 ) / 64 + ( FT_TS_Pos )spread;
         cbox.yMin = ( cbox.yMin - 63 ) / 64 - ( FT_TS_Pos )spread;
         cbox.yMax = ( cbox.yMax + 63 ) / 64 + ( FT_TS_Pos )spread;
 
-        /* now loop over the pixels in the control box. */
-        for ( y = cbox.yMin; y < cbox.yMax; y++ )
-        {
-          for ( x = cbox.xMin; x < cbox.xMax; x++ )
-          {
-            FT_TS_26D6_Vec          grid_point = zero_vector;
-            SDF_Signed_Distance  dist       = max_sdf;
-            FT_TS_UInt              index      = 0;
-            FT_TS_16D16             diff       = 0;
-
-
-            if ( x < 0 || x >= width )
-              continue;
-            if ( y < 0 || y >= rows )
-              continue;
+        job.edges[job.num_edges]  = edges;
+        job.cboxes[job.num_edges] = cbox;
+        job.num_edges++;
+      }
+    }
 
-            grid_point.x = FT_TS_INT_26D6( x );
-            grid_point.y = FT_TS_INT_26D6( y );
+    job.num_blocks = ( job.rows + SDF_BLOCK_ROWS - 1 ) / SDF_BLOCK_ROWS;
 
-            /* This `grid_point` is at the corner, but we */
-            /* use the center of the pixel.               */
-            grid_point.x += FT_TS_INT_26D6( 1 ) / 2;
-            grid_point.y += FT_TS_INT_26D6( 1 ) / 2;
+    num_threads = internal_params.threads;
+    if ( num_threads > (FT_TS_UInt)job.num_blocks )
+      num_threads = (FT_TS_UInt)job.num_blocks;
+    if ( bitmap->width * bitmap->rows < SDF_MIN_THREAD_PIXELS )
+      num_threads = 1;
 
-            FT_TS_CALL( sdf_edge_get_min_distance( edges,
-                                                grid_point,
-                                                &dist ) );
+#ifdef FT_TS_CONFIG_OPTION_SDF_THREADS
+    if ( num_threads > 1 )
+    {
+      pthread_t*  threads = NULL;
+      FT_TS_UInt  n, started = 0;
 
-            if ( internal_params.orientation == FT_TS_ORIENTATION_FILL_LEFT )
-              dist.sign = -dist.sign;
 
-            /* ignore if the distance is greater than spread;       */
-            /* otherwise it creates artifacts due to the wrong sign */
-            if ( dist.distance > sp_sq )
-              continue;
+      if ( FT_TS_QNEW_ARRAY( threads, num_threads - 1 ) )
+        goto Exit;
 
-            /* take the square root of the distance if required */
-            if ( USE_SQUARED_DISTANCES )
-              dist.distance = square_root( dist.distance );
+      pthread_mutex_init( &job.lock, NULL );
 
-            if ( internal_params.flip_y )
-              index = (FT_TS_UInt)( y * width + x );
-            else
-              index = (FT_TS_UInt)( ( rows - y - 1 ) * width + x );
+      /* the calling thread works, too; failing to */
+      /* start a thread only means less help       */
+      for ( n = 0; n < num_threads - 1; n++ )
+      {
+        if ( pthread_create( &threads[started], NULL,
+                             sdf_rows_worker, &job ) == 0 )
+          started++;
+      }
 
-            /* check whether the pixel is set or not */
-            if ( dists[index].sign == 0 )
-              dists[index] = dist;
-            else
-            {
-              diff = FT_TS_ABS( dists[index].distance - dist.distance );
+      sdf_rows_worker( &job );
 
-              if ( diff <= CORNER_CHECK_EPSILON )
-                dists[index] = resolve_corner( dists[index], dist );
-              else if ( dists[index].distance > dist.distance )
-                dists[index] = dist;
-            }
-          }
-        }
+      for ( n = 0; n < started; n++ )
+        pthread_join( threads[n], NULL );
 
-        edges = edges->next;
-      }
-
-      contours = contours->next;
+      pthread_mutex_destroy( &job.lock );
+      FT_TS_FREE( threads );
     }
-
-    /* final pass */
-    for ( j = 0; j < rows; j++ )
+    else
     {
-      /* We assume the starting pixel of each row is outside. */
-      FT_TS_Char  current_sign = -1;
-      FT_TS_UInt  index;
-
-
-      if ( internal_params.overload_sign != 0 )
-        current_sign = internal_params.overload_sign < 0 ? -1 : 1;
-
-      for ( i = 0; i < width; i++ )
-      {
-        index = (FT_TS_UInt)( j * width + i );
-
-        /* if the pixel is not set                     */
-        /* its shortest distance is more than `spread` */
-        if ( dists[index].sign == 0 )
-          dists[index].distance = fixed_spread;
-        else
-          current_sign = dists[index].sign;
-
-        /* clamp the values */
-        if ( dists[index].distance > fixed_spread )
-          dists[index].distance = fixed_spread;
-
-        /* flip sign if required */
-        dists[index].distance *= internal_params.flip_sign ? -current_sign
-                                                           :  current_sign;
-
-        /* concatenate to appropriate format */
-        buffer[index] = map_fixed_to_sdf( dists[index].distance,
-                                          fixed_spread );
-      }
+      pthread_mutex_init( &job.lock, NULL );
+      sdf_rows_worker( &job );
+      pthread_mutex_destroy( &job.lock );
     }
+#else
+    sdf_rows_worker( &job );
+#endif
+
+    error = job.error;
 
   Exit:
-    FT_TS_FREE( dists );
+    FT_TS_FREE( job.dists );
+    FT_TS_FREE( job.edges );
+    FT_TS_FREE( job.cboxes );
     return error;
   }
 
@@ -3877,6 +4076,8 @@
     internal_params.flip_sign     = sdf_params->flip_sign;
     internal_params.flip_y        = sdf_params->flip_y;
     internal_params.overload_sign = 0;
+    internal_params.threads       = sdf_params->threads ? sdf_params->threads
+                                                        : 1;
 
     FT_TS_CALL( sdf_shape_new( memory, &shape ) );
 
@@ -67,9 +67,21 @@ FT_TS_BEGIN_HEADER
    *     considerable amount of extra memory; additionally, it will not work
    *     if generating SDF from bitmap.
    *
+   *   threads ::
+   *     The maximum number of threads used to generate the SDF of an
+   *     outline; 0 is treated as~1.  Only effective if FreeType is built
+   *     with `FT_TS_CONFIG_OPTION_SDF_THREADS`.
+   *
+   *   separable ::
+   *     Set this to true to compute the distances of the 'bsdf' renderer
+   *     with an exact separable Euclidean distance transform instead of
+   *     the 8SED sweeps.
+   *
    * @note:
    *   All properties are valid for both the 'sdf' and 'bsdf' renderers; the
-   *   exception is `overlaps`, which gets ignored by the 'bsdf' renderer.
+   *   exceptions are `overlaps` and `threads`, which get ignored by the
+   *   'bsdf' renderer, and `separable`, which gets ignored by the 'sdf'
+   *   renderer.
    *
    */
   typedef struct  SDF_Raster_Params_
@@ -79,6 +91,8 @@ FT_TS_BEGIN_HEADER
     FT_TS_Bool           flip_sign;
     FT_TS_Bool           flip_y;
     FT_TS_Bool           overlaps;
+    FT_TS_UInt           threads;
+    FT_TS_Bool           separable;
 
   } SDF_Raster_Params;
 
@@ -118,6 +118,35 @@
                   " updated property `overlaps' to %d\n", val ));
     }
 
+    else if ( ft_strcmp( property_name, "threads" ) == 0 )
+    {
+      FT_TS_UInt  val = *(const FT_TS_UInt*)value;
+
+
+      if ( val < 1 )
+      {
+        FT_TS_TRACE0(( "[sdf] sdf_property_set:"
+                    " the `threads' property must be at least 1\n" ));
+
+        error = FT_TS_THROW( Invalid_Argument );
+        goto Exit;
+      }
+
+      render->threads = val;
+      FT_TS_TRACE7(( "[sdf] sdf_property_set:"
+                  " updated property `threads' to %d\n", val ));
+    }
+
+    else if ( ft_strcmp( property_name, "separable" ) == 0 )
+    {
+      FT_TS_Bool  val = *(const FT_TS_Bool*)value;
+
+
+      render->separable = val ? 1 : 0;
+      FT_TS_TRACE7(( "[sdf] sdf_property_set:"
+                  " updated property `separable' to %d\n", val ));
+    }
+
     else
     {
       FT_TS_TRACE0(( "[sdf] sdf_property_set:"
@@ -172,6 +201,22 @@
       *val = render->overlaps;
     }
 
+    else if ( ft_strcmp( property_name, "threads" ) == 0 )
+    {
+      FT_TS_UInt*  val = (FT_TS_UInt*)value;
+
+
+      *val = render->threads;
+    }
+
+    else if ( ft_strcmp( property_name, "separable" ) == 0 )
+    {
+      FT_TS_Bool*  val = (FT_TS_Bool*)value;
+
+
+      *val = render->separable;
+    }
+
     else
     {
       FT_TS_TRACE0(( "[sdf] sdf_property_get:"
@@ -230,6 +275,8 @@
     sdf_render->flip_sign = 0;
     sdf_render->flip_y    = 0;
     sdf_render->overlaps  = 0;
+    sdf_render->threads   = 1;
+    sdf_render->separable = 0;
 
     return FT_TS_Err_Ok;
   }
@@ -346,6 +393,7 @@
     params.flip_sign   = sdf_module->flip_sign;
     params.flip_y      = sdf_module->flip_y;
     params.overlaps    = sdf_module->overlaps;
+    params.threads     = sdf_module->threads;
 
     /* render the outline */
     error = render->raster_render( render->raster,
@@ -387,11 +435,7 @@
       goto Exit;
     }
 
-    if ( matrix )
-      FT_TS_Outline_Transform( &slot->outline, matrix );
-
-    if ( delta )
-      FT_TS_Outline_Translate( &slot->outline, delta->x, delta->y );
+    FT_TS_Outline_Transform_Translate( &slot->outline, matrix, delta );
 
   Exit:
     return error;
@@ -548,6 +592,7 @@
     params.spread      = sdf_module->spread;
     params.flip_sign   = sdf_module->flip_sign;
     params.flip_y      = sdf_module->flip_y;
+    params.separable   = sdf_module->separable;
 
     error = render->raster_render( render->raster,
                                    (const FT_TS_Raster_Params*)&params );
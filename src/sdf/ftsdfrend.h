@@ -66,9 +66,24 @@ FT_TS_BEGIN_HEADER
    *     considerable amount of extra memory; additionally, it will not work
    *     if generating SDF from bitmap.
    *
+   *   threads ::
+   *     The maximum number of threads used to generate the SDF of a large
+   *     outline, 1 by default.  The grid is split into blocks of rows,
+   *     and the output does not depend on the number of threads.  This
+   *     needs `FT_TS_CONFIG_OPTION_SDF_THREADS`; otherwise, the property is
+   *     accepted but has no effect.
+   *
+   *   separable ::
+   *     Set this to true to make the 'bsdf' renderer use a separable
+   *     distance transform (Felzenszwalb and Huttenlocher) instead of the
+   *     default 8SED algorithm.  It is faster for large spreads; the
+   *     distances are still measured to the approximated edge positions,
+   *     so the result differs slightly from 8SED but is not more precise.
+   *
    * @note:
-   *   All properties except `overlaps` are valid for both the 'sdf' and
-   *   'bsdf' renderers.
+   *   All properties except `overlaps`, `threads`, and `separable` are
+   *   valid for both the 'sdf' and 'bsdf' renderers; `separable` is only
+   *   valid for the 'bsdf' renderer.
    *
    */
   typedef struct  SDF_Renderer_Module_
@@ -78,6 +93,8 @@ FT_TS_BEGIN_HEADER
     FT_TS_Bool         flip_sign;
     FT_TS_Bool         flip_y;
     FT_TS_Bool         overlaps;
+    FT_TS_UInt         threads;
+    FT_TS_Bool         separable;
 
   } SDF_Renderer_Module, *SDF_Renderer;
 
@@ -45,6 +45,41 @@
 #define FT_TS_COMPONENT  ttsbit
 
 
+  /*
+   * A strike atlas holds all glyphs of an EBLC/EBDT strike, decoded into a
+   * single buffer whose rows all have the same pitch; glyph `n' starts at
+   * `buffer + glyphs[n].offset' and occupies `glyphs[n].metrics.height'
+   * rows.  The decoder's result for glyphs without an image (or with
+   * broken data) is stored, too, so that every load of a glyph from an
+   * atlased strike takes constant time.
+   */
+
+  /* number of glyph loads from a strike before we build its atlas */
+#define TT_SBIT_ATLAS_MIN_LOADS  16
+
+  typedef struct  TT_SBitAtlasGlyphRec_
+  {
+    FT_TS_ULong         offset;
+    FT_TS_Error         error;
+    TT_SBit_MetricsRec  metrics;
+
+  } TT_SBitAtlasGlyphRec, *TT_SBitAtlasGlyph;
+
+
+  typedef struct  TT_SBitAtlasRec_
+  {
+    FT_TS_UInt         loads;       /* glyph loads while not yet built */
+    FT_TS_Bool         failed;      /* too large or broken; never retry */
+
+    FT_TS_Byte         bit_depth;
+    FT_TS_ULong        pitch;
+    FT_TS_UInt         num_glyphs;
+    TT_SBitAtlasGlyph  glyphs;
+    FT_TS_Byte*        buffer;
+
+  } TT_SBitAtlasRec;
+
+
   FT_TS_LOCAL_DEF( FT_TS_Error )
   tt_face_load_sbit( TT_Face    face,
                      FT_TS_Stream  stream )
@@ -260,8 +295,31 @@
   tt_face_free_sbit( TT_Face  face )
   {
     FT_TS_Stream  stream = face->root.stream;
+    FT_TS_Memory  memory = face->root.memory;
+
+
+    if ( face->sbit_atlases )
+    {
+      FT_TS_UInt  n;
+
+
+      for ( n = 0; n < face->sbit_num_strikes; n++ )
+      {
+        TT_SBitAtlas  atlas = face->sbit_atlases[n];
 
 
+        if ( atlas )
+        {
+          FT_TS_FREE( atlas->glyphs );
+          FT_TS_FREE( atlas->buffer );
+          FT_TS_FREE( atlas );
+        }
+      }
+
+      FT_TS_FREE( face->sbit_atlases );
+      face->sbit_atlas_size = 0;
+    }
+
     FT_TS_FRAME_RELEASE( face->sbit_table );
     face->sbit_table_size  = 0;
     face->sbit_table_type  = TT_SBIT_TABLE_TYPE_NONE;
@@ -1460,6 +1518,274 @@
   }
 
 
+  /* decode all glyphs of a strike into `atlas' */
+  static FT_TS_Error
+  tt_sbit_atlas_build( TT_Face       face,
+                       FT_TS_ULong   strike_index,
+                       TT_SBitAtlas  atlas )
+  {
+    FT_TS_Error         error;
+    FT_TS_Memory        memory     = face->root.memory;
+    FT_TS_Bitmap*       map        = &face->root.glyph->bitmap;
+    FT_TS_UInt          num_glyphs = (FT_TS_UInt)face->root.num_glyphs;
+    TT_SBitDecoderRec   decoder[1];
+    TT_SBit_MetricsRec  metrics;
+    TT_SBitAtlasGlyph   glyph;
+    FT_TS_ULong         rows  = 0;
+    FT_TS_ULong         pitch = 0;
+    FT_TS_ULong         offset;
+    FT_TS_ULong         size;
+    FT_TS_UInt          gindex;
+
+
+    error = tt_sbit_decoder_init( decoder, face, strike_index, &metrics );
+    if ( error )
+      goto Exit;
+
+    if ( decoder->bit_depth > 8 )
+    {
+      error = FT_TS_THROW( Invalid_Table );
+      goto Exit;
+    }
+
+    size = (FT_TS_ULong)num_glyphs * sizeof ( TT_SBitAtlasGlyphRec );
+    if ( size > face->sbit_atlas_limit - face->sbit_atlas_size )
+    {
+      error = FT_TS_THROW( Array_Too_Large );
+      goto Exit;
+    }
+
+    if ( FT_TS_QNEW_ARRAY( atlas->glyphs, num_glyphs ) )
+      goto Exit;
+
+    /* first pass: metrics only, to get the atlas dimensions */
+    for ( gindex = 0, glyph = atlas->glyphs;
+          gindex < num_glyphs;
+          gindex++, glyph++ )
+    {
+      decoder->metrics_loaded   = 0;
+      decoder->bitmap_allocated = 0;
+
+      glyph->offset = 0;
+      glyph->error  = tt_sbit_decoder_load_image( decoder, gindex,
+                                                  0, 0, 0, 1 );
+      if ( FT_TS_ERR_EQ( glyph->error, Out_Of_Memory ) )
+      {
+        error = glyph->error;
+        goto Exit;
+      }
+
+      if ( !glyph->error )
+      {
+        FT_TS_ULong  glyph_pitch =
+          ( (FT_TS_ULong)metrics.width * decoder->bit_depth + 7 ) >> 3;
+
+
+        glyph->metrics = metrics;
+
+        rows += metrics.height;
+        if ( glyph_pitch > pitch )
+          pitch = glyph_pitch;
+      }
+    }
+
+    if ( pitch && rows > ( face->sbit_atlas_limit -
+                           face->sbit_atlas_size - size ) / pitch )
+    {
+      error = FT_TS_THROW( Array_Too_Large );
+      goto Exit;
+    }
+
+    if ( FT_TS_ALLOC( atlas->buffer, rows * pitch ) )
+      goto Exit;
+
+    /* second pass: decode and copy the images */
+    offset = 0;
+    for ( gindex = 0, glyph = atlas->glyphs;
+          gindex < num_glyphs;
+          gindex++, glyph++ )
+    {
+      FT_TS_Byte*  line;
+      FT_TS_UInt   height;
+
+
+      if ( glyph->error )
+        continue;
+
+      decoder->metrics_loaded   = 0;
+      decoder->bitmap_allocated = 0;
+
+      error = tt_sbit_decoder_load_image( decoder, gindex, 0, 0, 0, 0 );
+      if ( FT_TS_ERR_EQ( error, Out_Of_Memory ) )
+        goto Exit;
+
+      height = glyph->metrics.height;
+
+      /* the dimensions must match the first pass */
+      if ( error                                   ||
+           map->rows != height                     ||
+           metrics.height != height                ||
+           metrics.width != glyph->metrics.width   ||
+           (FT_TS_ULong)map->pitch > pitch         )
+      {
+        glyph->error = error ? error : FT_TS_THROW( Invalid_Table );
+        continue;
+      }
+
+      glyph->metrics = metrics;
+      glyph->offset  = offset;
+
+      for ( line = map->buffer; height > 0; height-- )
+      {
+        FT_TS_MEM_COPY( atlas->buffer + offset, line, map->pitch );
+
+        line   += map->pitch;
+        offset += pitch;
+      }
+    }
+
+    atlas->bit_depth  = decoder->bit_depth;
+    atlas->pitch      = pitch;
+    atlas->num_glyphs = num_glyphs;
+
+    face->sbit_atlas_size += size + rows * pitch;
+
+    FT_TS_TRACE3(( "tt_sbit_atlas_build: strike %lu decoded,"
+                   " %lu rows with pitch %lu\n",
+                   strike_index, rows, pitch ));
+    error = FT_TS_Err_Ok;
+
+  Exit:
+    tt_sbit_decoder_done( decoder );
+
+    if ( error )
+    {
+      FT_TS_FREE( atlas->glyphs );
+      FT_TS_FREE( atlas->buffer );
+    }
+
+    return error;
+  }
+
+
+  /*
+   * Try to load a glyph from the atlas of its strike, building the atlas
+   * first if the strike is used often enough.  Return FALSE if the caller
+   * should use the decoder instead; otherwise, `*aerror' is the result.
+   */
+  static FT_TS_Bool
+  tt_sbit_atlas_load( TT_Face              face,
+                      FT_TS_ULong          strike_index,
+                      FT_TS_UInt           glyph_index,
+                      FT_TS_Bool           metrics_only,
+                      TT_SBit_MetricsRec*  metrics,
+                      FT_TS_Error         *aerror )
+  {
+    FT_TS_Error        error;
+    FT_TS_Memory       memory = face->root.memory;
+    FT_TS_GlyphSlot    slot   = face->root.glyph;
+    FT_TS_Bitmap*      map    = &slot->bitmap;
+    TT_SBitAtlas       atlas;
+    TT_SBitAtlasGlyph  glyph;
+    FT_TS_ULong        size;
+
+
+    if ( strike_index >= face->sbit_num_strikes )
+      return FALSE;
+
+    if ( !face->sbit_atlases                                          &&
+         FT_TS_NEW_ARRAY( face->sbit_atlases, face->sbit_num_strikes ) )
+      return FALSE;
+
+    atlas = face->sbit_atlases[strike_index];
+    if ( !atlas )
+    {
+      if ( FT_TS_NEW( atlas ) )
+        return FALSE;
+
+      face->sbit_atlases[strike_index] = atlas;
+    }
+
+    if ( !atlas->glyphs )
+    {
+      if ( atlas->failed                                  ||
+           ++atlas->loads < TT_SBIT_ATLAS_MIN_LOADS       )
+        return FALSE;
+
+      if ( tt_sbit_atlas_build( face, strike_index, atlas ) )
+      {
+        atlas->failed = 1;
+        return FALSE;
+      }
+    }
+
+    if ( glyph_index >= atlas->num_glyphs )
+      return FALSE;
+
+    glyph = atlas->glyphs + glyph_index;
+
+    if ( glyph->error )
+    {
+      *aerror = glyph->error;
+      return TRUE;
+    }
+
+    *metrics = glyph->metrics;
+
+    map->width = metrics->width;
+    map->rows  = metrics->height;
+    map->pitch = (int)( ( map->width * atlas->bit_depth + 7 ) >> 3 );
+
+    switch ( atlas->bit_depth )
+    {
+    case 1:
+      map->pixel_mode = FT_TS_PIXEL_MODE_MONO;
+      map->num_grays  = 2;
+      break;
+
+    case 2:
+      map->pixel_mode = FT_TS_PIXEL_MODE_GRAY2;
+      map->num_grays  = 4;
+      break;
+
+    case 4:
+      map->pixel_mode = FT_TS_PIXEL_MODE_GRAY4;
+      map->num_grays  = 16;
+      break;
+
+    default:
+      map->pixel_mode = FT_TS_PIXEL_MODE_GRAY;
+      map->num_grays  = 256;
+    }
+
+    size  = map->rows * (FT_TS_ULong)map->pitch;
+    error = FT_TS_Err_Ok;
+
+    if ( size && !metrics_only )
+    {
+      error = ft_glyphslot_alloc_bitmap( slot, size );
+      if ( !error )
+      {
+        FT_TS_Byte*  line  = atlas->buffer + glyph->offset;
+        FT_TS_Byte*  write = map->buffer;
+        FT_TS_UInt   count = map->rows;
+
+
+        for ( ; count > 0; count-- )
+        {
+          FT_TS_MEM_COPY( write, line, map->pitch );
+
+          line  += atlas->pitch;
+          write += map->pitch;
+        }
+      }
+    }
+
+    *aerror = error;
+    return TRUE;
+  }
+
+
   static FT_TS_Error
   tt_face_load_sbix_image( TT_Face              face,
                            FT_TS_ULong             strike_index,
@@ -1624,6 +1950,17 @@
         TT_SBitDecoderRec  decoder[1];
 
 
+        if ( face->sbit_atlas_limit                                &&
+             face->sbit_table_type == TT_SBIT_TABLE_TYPE_EBLC      &&
+             tt_sbit_atlas_load(
+               face,
+               strike_index,
+               glyph_index,
+               ( load_flags & FT_TS_LOAD_BITMAP_METRICS_ONLY ) != 0,
+               metrics,
+               &error )                                            )
+          break;
+
         error = tt_sbit_decoder_init( decoder, face, strike_index, metrics );
         if ( !error )
         {
@@ -47,6 +47,26 @@
   FT_TS_EXPORT_VAR( const FT_TS_Raster_Funcs )  ft_grays_raster;
 
 
+  /**************************************************************************
+   *
+   * Modes for the `raster_set_mode' function of `ft_grays_raster'.  The
+   * pool limit is passed as a pointer to an `unsigned long' (in bytes);
+   * the statistics are returned in an `FT_TS_Gray_Stats' structure.
+   */
+#define FT_TS_GRAY_MODE_SET_POOL_LIMIT  0x706C6D73UL  /* 'plms' */
+#define FT_TS_GRAY_MODE_GET_POOL_LIMIT  0x706C6D67UL  /* 'plmg' */
+#define FT_TS_GRAY_MODE_GET_STATS       0x73746167UL  /* 'stag' */
+#define FT_TS_GRAY_MODE_RESET_STATS     0x73746172UL  /* 'star' */
+
+  typedef struct  FT_TS_Gray_Stats_
+  {
+    unsigned long  band_restarts;  /* bands rendered again on overflow */
+    unsigned long  pool_size;      /* largest cell pool, in bytes      */
+    unsigned long  pool_peak;      /* largest pool usage, in bytes     */
+
+  } FT_TS_Gray_Stats;
+
+
 #ifdef __cplusplus
   }
 #endif
@@ -18,13 +18,25 @@
 
 #include <freetype/internal/ftdebug.h>
 #include <freetype/internal/ftobjs.h>
+#include <freetype/internal/services/svprop.h>
 #include <freetype/ftoutln.h>
+#include <freetype/ftdriver.h>
 #include "ftsmooth.h"
 #include "ftgrays.h"
 
 #include "ftsmerrs.h"
 
 
+  /**************************************************************************
+   *
+   * The macro FT_TS_COMPONENT is used in trace mode.  It is an implicit
+   * parameter of the FT_TS_TRACE() and FT_TS_ERROR() macros, used to print/log
+   * messages during execution.
+   */
+#undef  FT_TS_COMPONENT
+#define FT_TS_COMPONENT  smooth
+
+
   /* sets render-specific mode */
   static FT_TS_Error
   ft_smooth_set_mode( FT_TS_Renderer  render,
@@ -53,11 +65,7 @@
       goto Exit;
     }
 
-    if ( matrix )
-      FT_TS_Outline_Transform( &slot->outline, matrix );
-
-    if ( delta )
-      FT_TS_Outline_Translate( &slot->outline, delta->x, delta->y );
+    FT_TS_Outline_Transform_Translate( &slot->outline, matrix, delta );
 
   Exit:
     return error;
@@ -124,6 +132,142 @@
   }
 
 
+  /* If all subpixels of `sub' are shifted by multiples of a third of a */
+  /* pixel along the stripes, up to rounding, store the multiples in    */
+  /* `thirds' and return TRUE.  This is the case for the default RGB    */
+  /* and BGR geometries.                                                */
+  static FT_TS_Bool
+  ft_smooth_lcd_thirds( const FT_TS_Vector*  sub,
+                        FT_TS_Int*           thirds )
+  {
+    int  i;
+
+
+    for ( i = 0; i < 3; i++ )
+    {
+      FT_TS_Pos  s = 3 * sub[i].x;
+      FT_TS_Int  m = s >= 32 ? 1 : s <= -32 ? -1 : 0;
+
+
+      if ( sub[i].y || s - 64 * m < -2 || s - 64 * m > 2 )
+        return FALSE;
+
+      thirds[i] = m;
+    }
+
+    return TRUE;
+  }
+
+
+  /* Render all subpixels in one pass: the outline is rasterized once at */
+  /* three times the resolution across the stripes, with a margin of    */
+  /* one third of a pixel, and every subpixel is the average of the     */
+  /* three thirds it covers.  Within rounding, this gives the same       */
+  /* coverage as rendering the shifted outline three times.              */
+  static FT_TS_Error
+  ft_smooth_raster_lcd_single( FT_TS_Renderer    render,
+                               FT_TS_Outline*    outline,
+                               FT_TS_Bitmap*     bitmap,
+                               FT_TS_Bool        vertical,
+                               const FT_TS_Int*  thirds )
+  {
+    FT_TS_Error    error      = FT_TS_Err_Ok;
+    FT_TS_Memory   memory     = render->root.memory;
+    FT_TS_Vector*  points     = outline->points;
+    FT_TS_Vector*  points_end = FT_TS_OFFSET( points, outline->n_points );
+    FT_TS_Vector*  vec;
+
+    FT_TS_Raster_Params  params;
+    FT_TS_Bitmap         thin;
+    unsigned int         r, c;
+
+
+    FT_TS_ZERO( &thin );
+    thin.pixel_mode = FT_TS_PIXEL_MODE_GRAY;
+    thin.num_grays  = 256;
+    thin.width      = bitmap->width + ( vertical ? 0 : 2 );
+    thin.rows       = bitmap->rows  + ( vertical ? 2 : 0 );
+    thin.pitch      = (int)thin.width;
+
+    if ( FT_TS_ALLOC_MULT( thin.buffer, thin.rows, thin.pitch ) )
+      return error;
+
+    params.target = &thin;
+    params.source = outline;
+    params.flags  = FT_TS_RASTER_FLAG_AA;
+
+    /* implode outline */
+    if ( vertical )
+      for ( vec = points; vec < points_end; vec++ )
+        vec->y = 3 * vec->y + 64;
+    else
+      for ( vec = points; vec < points_end; vec++ )
+        vec->x = 3 * vec->x + 64;
+
+    error = render->raster_render( render->raster, &params );
+
+    /* deflate outline */
+    if ( vertical )
+      for ( vec = points; vec < points_end; vec++ )
+        vec->y = ( vec->y - 64 ) / 3;
+    else
+      for ( vec = points; vec < points_end; vec++ )
+        vec->x = ( vec->x - 64 ) / 3;
+
+    if ( error )
+      goto Exit;
+
+    /* subpixel `3k + i' averages the thirds `3k + thirds[i] + 1 + {0,1,2}' */
+    /* of the margined bitmap                                               */
+    if ( vertical )
+    {
+      for ( r = 0; r < bitmap->rows; r++ )
+      {
+        unsigned char*  dst = bitmap->buffer + r * (unsigned int)bitmap->pitch;
+        unsigned int    t   = r - r % 3 + (unsigned int)( thirds[r % 3] + 1 );
+        unsigned char*  src = thin.buffer + t * (unsigned int)thin.pitch;
+
+
+        for ( c = 0; c < bitmap->width; c++ )
+          dst[c] = (unsigned char)( ( src[c]                  +
+                                      src[c + thin.pitch]     +
+                                      src[c + 2 * thin.pitch] + 1 ) / 3 );
+      }
+    }
+    else
+    {
+      int  o0 = thirds[0] + 1;
+      int  o1 = thirds[1] + 1;
+      int  o2 = thirds[2] + 1;
+
+
+      for ( r = 0; r < bitmap->rows; r++ )
+      {
+        unsigned char*  dst = bitmap->buffer + r * (unsigned int)bitmap->pitch;
+        unsigned char*  src = thin.buffer + r * (unsigned int)thin.pitch;
+
+
+        for ( c = 0; c + 2 < bitmap->width; c += 3 )
+        {
+          unsigned char*  s0 = src + (int)c + o0;
+          unsigned char*  s1 = src + (int)c + o1;
+          unsigned char*  s2 = src + (int)c + o2;
+
+
+          dst[c]     = (unsigned char)( ( s0[0] + s0[1] + s0[2] + 1 ) / 3 );
+          dst[c + 1] = (unsigned char)( ( s1[0] + s1[1] + s1[2] + 1 ) / 3 );
+          dst[c + 2] = (unsigned char)( ( s2[0] + s2[1] + s2[2] + 1 ) / 3 );
+        }
+      }
+    }
+
+  Exit:
+    FT_TS_FREE( thin.buffer );
+
+    return error;
+  }
+
+
   static FT_TS_Error
   ft_smooth_raster_lcd( FT_TS_Renderer  render,
                         FT_TS_Outline*  outline,
@@ -132,11 +276,17 @@
     FT_TS_Error      error = FT_TS_Err_Ok;
     FT_TS_Vector*    sub   = render->root.library->lcd_geometry;
     FT_TS_Pos        x, y;
+    FT_TS_Int        thirds[3];
 
     FT_TS_Raster_Params   params;
     TOrigin            target;
 
 
+    if ( ( (FT_TS_Smooth_Renderer)render )->lcd_single_pass &&
+         ft_smooth_lcd_thirds( sub, thirds )                )
+      return ft_smooth_raster_lcd_single( render, outline, bitmap,
+                                          FALSE, thirds );
+
     /* Render 3 separate coverage bitmaps, shifting the outline.  */
     /* Set up direct rendering to record them on each third byte. */
     params.source     = outline;
@@ -200,10 +350,16 @@
     int          pitch = bitmap->pitch;
     FT_TS_Vector*   sub   = render->root.library->lcd_geometry;
     FT_TS_Pos       x, y;
+    FT_TS_Int       thirds[3];
 
     FT_TS_Raster_Params  params;
 
 
+    if ( ( (FT_TS_Smooth_Renderer)render )->lcd_single_pass &&
+         ft_smooth_lcd_thirds( sub, thirds )                )
+      return ft_smooth_raster_lcd_single( render, outline, bitmap,
+                                          TRUE, thirds );
+
     params.target = bitmap;
     params.source = outline;
     params.flags  = FT_TS_RASTER_FLAG_AA;
@@ -424,6 +580,129 @@
 
 #undef SCALE
 
+
+  typedef struct TPacked_
+  {
+    unsigned char*  origin;  /* pixmap origin at the bottom-left */
+    int             pitch;   /* pitch to go down one row */
+    int             bits;    /* bits per pixel, 2 or 4 */
+    int             dither;  /* whether to apply ordered dithering */
+    int             dx, dy;  /* dither matrix phase */
+
+  } TPacked;
+
+
+  /* 4x4 Bayer matrix for ordered dithering */
+  static const unsigned char  ft_smooth_bayer[4][4] =
+  {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 }
+  };
+
+
+  /* This function quantizes spans to 2 or 4 bits in direct rendering */
+  /* mode, filling whole bytes of undithered spans at once.          */
+  static void
+  ft_smooth_packed_spans( int             y,
+                          int             count,
+                          const FT_TS_Span*  spans,
+                          TPacked*        target )
+  {
+    unsigned char*  dst  = target->origin - y * target->pitch;
+    int             bits = target->bits;
+    int             ppb  = 8 / bits;   /* pixels per byte */
+    unsigned int    max  = ( 1U << bits ) - 1;
+
+    const unsigned char*  thresh = ft_smooth_bayer[( y + target->dy ) & 3];
+
+
+    for ( ; count--; spans++ )
+    {
+      int           x   = spans->x;
+      int           end = x + spans->len;
+      unsigned int  c   = spans->coverage;
+      unsigned int  v   = ( c * max + 127 ) / 255;
+
+
+      if ( target->dither )
+      {
+        /* thresholds `t / 16' of a level, so that 0 and 255 are kept */
+        for ( ; x < end; x++ )
+        {
+          unsigned int  t = thresh[( x + target->dx ) & 3];
+
+
+          v = ( c * max * 16 + t * 255 + 128 ) / ( 255 * 16 );
+
+          dst[x / ppb] |= (unsigned char)( v << ( 8 - bits * ( x % ppb + 1 ) ) );
+        }
+        continue;
+      }
+
+      if ( !v )
+        continue;
+
+      for ( ; x < end && x % ppb; x++ )
+        dst[x / ppb] |= (unsigned char)( v << ( 8 - bits * ( x % ppb + 1 ) ) );
+
+      if ( end - x >= ppb )
+      {
+        /* replicate the level across the byte */
+        int  fill = (int)( v * ( bits == 2 ? 0x55U : 0x11U ) );
+        int  n    = ( end - x ) / ppb;
+
+
+        FT_TS_MEM_SET( dst + x / ppb, fill, n );
+        x += n * ppb;
+      }
+
+      for ( ; x < end; x++ )
+        dst[x / ppb] |= (unsigned char)( v << ( 8 - bits * ( x % ppb + 1 ) ) );
+    }
+  }
+
+
+  /* Render 2-bit or 4-bit gray levels directly into the packed bitmap; */
+  /* `dx' and `dy' align the dither matrix with the pixel grid.         */
+  static FT_TS_Error
+  ft_smooth_raster_packed( FT_TS_Renderer  render,
+                           FT_TS_Outline*  outline,
+                           FT_TS_Bitmap*   bitmap,
+                           FT_TS_Int       dx,
+                           FT_TS_Int       dy )
+  {
+    FT_TS_Raster_Params  params;
+    TPacked           target;
+
+
+    params.source     = outline;
+    params.flags      = FT_TS_RASTER_FLAG_AA | FT_TS_RASTER_FLAG_DIRECT;
+    params.gray_spans = (FT_TS_SpanFunc)ft_smooth_packed_spans;
+    params.user       = &target;
+
+    params.clip_box.xMin = 0;
+    params.clip_box.yMin = 0;
+    params.clip_box.xMax = bitmap->width;
+    params.clip_box.yMax = bitmap->rows;
+
+    if ( bitmap->pitch < 0 )
+      target.origin = bitmap->buffer;
+    else
+      target.origin = bitmap->buffer
+                      + ( bitmap->rows - 1 ) * (unsigned int)bitmap->pitch;
+
+    target.pitch  = bitmap->pitch;
+    target.bits   = bitmap->pixel_mode == FT_TS_PIXEL_MODE_GRAY2 ? 2 : 4;
+    target.dither = ( (FT_TS_Smooth_Renderer)render )->gray_dither;
+    target.dx     = dx & 3;
+    target.dy     = dy & 3;
+
+    return render->raster_render( render->raster, &params );
+  }
+
+
   static FT_TS_Error
   ft_smooth_render( FT_TS_Renderer       render,
                     FT_TS_GlyphSlot      slot,
@@ -449,7 +728,9 @@
     if ( mode != FT_TS_RENDER_MODE_NORMAL &&
          mode != FT_TS_RENDER_MODE_LIGHT  &&
          mode != FT_TS_RENDER_MODE_LCD    &&
-         mode != FT_TS_RENDER_MODE_LCD_V  )
+         mode != FT_TS_RENDER_MODE_LCD_V  &&
+         mode != FT_TS_RENDER_MODE_GRAY2  &&
+         mode != FT_TS_RENDER_MODE_GRAY4  )
     {
       error = FT_TS_THROW( Cannot_Render_Glyph );
       goto Exit;
@@ -497,7 +778,10 @@
     if ( mode == FT_TS_RENDER_MODE_NORMAL ||
          mode == FT_TS_RENDER_MODE_LIGHT  )
     {
-      if ( outline->flags & FT_TS_OUTLINE_OVERLAP )
+      /* the raster handles most overlaps itself with the non-zero */
+      /* rule; the others are oversampled                          */
+      if ( ( outline->flags & FT_TS_OUTLINE_OVERLAP )       &&
+           ( outline->flags & FT_TS_OUTLINE_EVEN_ODD_FILL ) )
         error = ft_smooth_raster_overlap( render, outline, bitmap );
       else
       {
@@ -506,11 +790,25 @@
 
         params.target = bitmap;
         params.source = outline;
-        params.flags  = FT_TS_RASTER_FLAG_AA;
+        params.flags  = FT_TS_RASTER_FLAG_AA |
+                        FT_TS_RASTER_FLAG_OVERLAP_STRICT;
 
         error = render->raster_render( render->raster, &params );
+
+        if ( FT_TS_ERR_EQ( error, Cannot_Render_Glyph ) &&
+             ( outline->flags & FT_TS_OUTLINE_OVERLAP ) )
+          error = ft_smooth_raster_overlap( render, outline, bitmap );
       }
     }
+    else if ( mode == FT_TS_RENDER_MODE_GRAY2 ||
+              mode == FT_TS_RENDER_MODE_GRAY4 )
+    {
+      /* even-odd overlaps are not oversampled here */
+      error = ft_smooth_raster_packed( render, outline, bitmap,
+                                       slot->bitmap_left,
+                                       slot->bitmap_top -
+                                         (FT_TS_Int)bitmap->rows );
+    }
     else
     {
       if ( mode == FT_TS_RENDER_MODE_LCD )
@@ -565,11 +863,185 @@
   }
 
 
+  /**************************************************************************
+   *
+   * PROPERTY SERVICE
+   *
+   */
+
+  static FT_TS_Error
+  ft_smooth_property_set( FT_TS_Module    module,        /* FT_TS_Renderer */
+                          const char*  property_name,
+                          const void*  value,
+                          FT_TS_Bool      value_is_string )
+  {
+    FT_TS_Renderer  render = (FT_TS_Renderer)module;
+
+#ifndef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+    FT_TS_UNUSED( value_is_string );
+#endif
+
+
+    if ( !ft_strcmp( property_name, "raster-pool-limit" ) )
+    {
+      unsigned long  limit;
+
+
+#ifdef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+
+
+        limit = (unsigned long)ft_strtol( s, NULL, 10 );
+      }
+      else
+#endif
+        limit = *(const FT_TS_ULong*)value;
+
+      return ft_smooth_set_mode( render,
+                                 FT_TS_GRAY_MODE_SET_POOL_LIMIT,
+                                 &limit );
+    }
+
+    if ( !ft_strcmp( property_name, "lcd-single-pass" ) )
+    {
+      FT_TS_Smooth_Renderer  smooth = (FT_TS_Smooth_Renderer)render;
+
+
+#ifdef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+
+
+        smooth->lcd_single_pass = ft_strtol( s, NULL, 10 ) ? TRUE : FALSE;
+      }
+      else
+#endif
+        smooth->lcd_single_pass = *(const FT_TS_Bool*)value;
+
+      return FT_TS_Err_Ok;
+    }
+
+    if ( !ft_strcmp( property_name, "gray-dither" ) )
+    {
+      FT_TS_Smooth_Renderer  smooth = (FT_TS_Smooth_Renderer)render;
+
+
+#ifdef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+
+
+        smooth->gray_dither = ft_strtol( s, NULL, 10 ) ? TRUE : FALSE;
+      }
+      else
+#endif
+        smooth->gray_dither = *(const FT_TS_Bool*)value;
+
+      return FT_TS_Err_Ok;
+    }
+
+    /* setting `raster-stats' to any value resets the counters */
+    if ( !ft_strcmp( property_name, "raster-stats" ) )
+      return ft_smooth_set_mode( render, FT_TS_GRAY_MODE_RESET_STATS, NULL );
+
+    FT_TS_TRACE2(( "ft_smooth_property_set: missing property `%s'\n",
+                property_name ));
+    return FT_TS_THROW( Missing_Property );
+  }
+
+
+  static FT_TS_Error
+  ft_smooth_property_get( FT_TS_Module    module,        /* FT_TS_Renderer */
+                          const char*  property_name,
+                          void*        value )
+  {
+    FT_TS_Renderer  render = (FT_TS_Renderer)module;
+
+
+    if ( !ft_strcmp( property_name, "raster-pool-limit" ) )
+    {
+      FT_TS_ULong*     val = (FT_TS_ULong*)value;
+      unsigned long  limit;
+
+
+      ft_smooth_set_mode( render, FT_TS_GRAY_MODE_GET_POOL_LIMIT, &limit );
+      *val = limit;
+
+      return FT_TS_Err_Ok;
+    }
+
+    if ( !ft_strcmp( property_name, "lcd-single-pass" ) )
+    {
+      FT_TS_Bool*  val = (FT_TS_Bool*)value;
+
+
+      *val = ( (FT_TS_Smooth_Renderer)render )->lcd_single_pass;
+
+      return FT_TS_Err_Ok;
+    }
+
+    if ( !ft_strcmp( property_name, "gray-dither" ) )
+    {
+      FT_TS_Bool*  val = (FT_TS_Bool*)value;
+
+
+      *val = ( (FT_TS_Smooth_Renderer)render )->gray_dither;
+
+      return FT_TS_Err_Ok;
+    }
+
+    if ( !ft_strcmp( property_name, "raster-stats" ) )
+    {
+      FT_TS_Prop_RasterStats*  val = (FT_TS_Prop_RasterStats*)value;
+      FT_TS_Gray_Stats         stats;
+
+
+      ft_smooth_set_mode( render, FT_TS_GRAY_MODE_GET_STATS, &stats );
+      val->band_restarts = stats.band_restarts;
+      val->pool_size     = stats.pool_size;
+      val->pool_peak     = stats.pool_peak;
+
+      return FT_TS_Err_Ok;
+    }
+
+    FT_TS_TRACE2(( "ft_smooth_property_get: missing property `%s'\n",
+                property_name ));
+    return FT_TS_THROW( Missing_Property );
+  }
+
+
+  FT_TS_DEFINE_SERVICE_PROPERTIESREC(
+    ft_smooth_service_properties,
+
+    (FT_TS_Properties_SetFunc)ft_smooth_property_set,     /* set_property */
+    (FT_TS_Properties_GetFunc)ft_smooth_property_get )    /* get_property */
+
+
+  FT_TS_DEFINE_SERVICEDESCREC1(
+    ft_smooth_services,
+
+    FT_TS_SERVICE_ID_PROPERTIES, &ft_smooth_service_properties )
+
+
+  static FT_TS_Module_Interface
+  ft_smooth_requester( FT_TS_Module    module,
+                       const char*  module_interface )
+  {
+    FT_TS_UNUSED( module );
+
+    return ft_service_list_lookup( ft_smooth_services, module_interface );
+  }
+
+
   FT_TS_DEFINE_RENDERER(
     ft_smooth_renderer_class,
 
       FT_TS_MODULE_RENDERER,
-      sizeof ( FT_TS_RendererRec ),
+      sizeof ( FT_TS_Smooth_RendererRec ),
 
       "smooth",
       0x10000L,
@@ -577,9 +1049,9 @@
 
       NULL,    /* module specific interface */
 
-      (FT_TS_Module_Constructor)ft_smooth_init,  /* module_init   */
-      (FT_TS_Module_Destructor) NULL,            /* module_done   */
-      (FT_TS_Module_Requester)  NULL,            /* get_interface */
+      (FT_TS_Module_Constructor)ft_smooth_init,       /* module_init   */
+      (FT_TS_Module_Destructor) NULL,                 /* module_done   */
+      (FT_TS_Module_Requester)  ft_smooth_requester,  /* get_interface */
 
     FT_TS_GLYPH_FORMAT_OUTLINE,
 
@@ -26,6 +26,16 @@
 FT_TS_BEGIN_HEADER
 
 
+  /* the `smooth' renderer, with its properties */
+  typedef struct  FT_TS_Smooth_RendererRec_
+  {
+    FT_TS_RendererRec  root;
+    FT_TS_Bool         lcd_single_pass;  /* see `lcd-single-pass' */
+    FT_TS_Bool         gray_dither;      /* see `gray-dither'     */
+
+  } FT_TS_Smooth_RendererRec, *FT_TS_Smooth_Renderer;
+
+
   FT_TS_DECLARE_RENDERER( ft_smooth_renderer_class )
 
 
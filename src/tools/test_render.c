@@ -0,0 +1,264 @@
+/*
+ * Profile the outline rasterizers.
+ *
+ *   test_render fontfile [size [repeat]]
+ *
+ * All outline glyphs of `fontfile' are loaded at `size' pixels and then
+ * rendered `repeat' times into gray and monochrome bitmaps.  For
+ * reference, the time needed by `FT_TS_Outline_Decompose' with empty
+ * callbacks is shown, too.
+ *
+ * To compare the smooth rasterizer's direct outline walker with the
+ * generic callback path, run this program once against a library built
+ * normally and once against a library built with
+ * `-DGRAY_DECOMPOSE_CALLBACKS=1', using both Latin and CJK fonts.
+ */
+
+#include <freetype/freetype.h>
+#include <freetype/ftoutln.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>    /* for clock() */
+
+/* SunOS 4.1.* does not define CLOCKS_PER_SEC, so include <sys/param.h> */
+/* to get the HZ macro which is the equivalent.                         */
+#if defined(__sun__) && !defined(SVR4) && !defined(__SVR4)
+#include <sys/param.h>
+#define CLOCKS_PER_SEC HZ
+#endif
+
+  static long
+  get_time( void )
+  {
+    return clock() * 10000L / CLOCKS_PER_SEC;
+  }
+
+
+  static long  num_segments;
+
+  static int
+  count_move_to( const FT_TS_Vector*  to,
+                 void*             user )
+  {
+    (void)to;
+    (void)user;
+
+    return 0;
+  }
+
+  static int
+  count_line_to( const FT_TS_Vector*  to,
+                 void*             user )
+  {
+    (void)to;
+    (void)user;
+
+    num_segments++;
+    return 0;
+  }
+
+  static int
+  count_conic_to( const FT_TS_Vector*  control,
+                  const FT_TS_Vector*  to,
+                  void*             user )
+  {
+    (void)control;
+    (void)to;
+    (void)user;
+
+    num_segments++;
+    return 0;
+  }
+
+  static int
+  count_cubic_to( const FT_TS_Vector*  control1,
+                  const FT_TS_Vector*  control2,
+                  const FT_TS_Vector*  to,
+                  void*             user )
+  {
+    (void)control1;
+    (void)control2;
+    (void)to;
+    (void)user;
+
+    num_segments++;
+    return 0;
+  }
+
+  static const FT_TS_Outline_Funcs  count_funcs =
+  {
+    count_move_to,
+    count_line_to,
+    count_conic_to,
+    count_cubic_to,
+    0,
+    0
+  };
+
+
+  typedef struct  GlyphRec_
+  {
+    FT_TS_Outline  outline;
+    FT_TS_Bitmap   gray;
+    FT_TS_Bitmap   mono;
+
+  } GlyphRec;
+
+
+  static void
+  setup_bitmap( FT_TS_Bitmap*      bitmap,
+                FT_TS_BBox*        cbox,
+                FT_TS_Pixel_Mode   mode )
+  {
+    memset( bitmap, 0, sizeof ( *bitmap ) );
+
+    bitmap->width      = (unsigned int)( ( cbox->xMax - cbox->xMin ) >> 6 );
+    bitmap->rows       = (unsigned int)( ( cbox->yMax - cbox->yMin ) >> 6 );
+    bitmap->pixel_mode = (unsigned char)mode;
+
+    if ( mode == FT_TS_PIXEL_MODE_MONO )
+      bitmap->pitch = (int)( ( bitmap->width + 15 ) >> 4 ) << 1;
+    else
+    {
+      bitmap->pitch     = (int)( ( bitmap->width + 3 ) & ~3U );
+      bitmap->num_grays = 256;
+    }
+
+    bitmap->buffer = (unsigned char*)calloc( 1, (size_t)bitmap->pitch *
+                                                bitmap->rows + 1 );
+  }
+
+
+  static void
+  profile_render( FT_TS_Library  library,
+                  GlyphRec*   glyphs,
+                  int         count,
+                  long        repeat )
+  {
+    long  time0;
+    long  r;
+    int   i;
+
+
+    num_segments = 0;
+
+    time0 = get_time();
+    for ( r = repeat; r > 0; r-- )
+      for ( i = 0; i < count; i++ )
+        FT_TS_Outline_Decompose( &glyphs[i].outline, &count_funcs, NULL );
+
+    time0 = get_time() - time0;
+    printf( "decompose: %6.3fs (%ld segments per pass)\n",
+            time0 / 10000.0, num_segments / repeat );
+
+    time0 = get_time();
+    for ( r = repeat; r > 0; r-- )
+      for ( i = 0; i < count; i++ )
+        FT_TS_Outline_Get_Bitmap( library,
+                               &glyphs[i].outline,
+                               &glyphs[i].gray );
+
+    time0 = get_time() - time0;
+    printf( "smooth:    %6.3fs\n", time0 / 10000.0 );
+
+    time0 = get_time();
+    for ( r = repeat; r > 0; r-- )
+      for ( i = 0; i < count; i++ )
+        FT_TS_Outline_Get_Bitmap( library,
+                               &glyphs[i].outline,
+                               &glyphs[i].mono );
+
+    time0 = get_time() - time0;
+    printf( "mono:      %6.3fs\n", time0 / 10000.0 );
+  }
+
+
+  int  main( int  argc, char**  argv )
+  {
+    FT_TS_Library  library;
+    FT_TS_Face     face;
+    GlyphRec*   glyphs;
+    int         size   = 48;
+    long        repeat = 10;
+    int         count  = 0;
+    long        gindex;
+    int         i;
+
+
+    if ( argc < 2 )
+    {
+      fprintf( stderr, "usage: test_render fontfile [size [repeat]]\n" );
+      return 1;
+    }
+
+    if ( argc > 2 )
+      size = atoi( argv[2] );
+    if ( argc > 3 )
+      repeat = atol( argv[3] );
+
+    if ( FT_TS_Init_FreeType( &library )                   ||
+         FT_TS_New_Face( library, argv[1], 0, &face )      ||
+         FT_TS_Set_Pixel_Sizes( face, 0, (FT_TS_UInt)size ) )
+    {
+      fprintf( stderr, "cannot open `%s'\n", argv[1] );
+      return 1;
+    }
+
+    glyphs = (GlyphRec*)calloc( (size_t)face->num_glyphs, sizeof ( GlyphRec ) );
+
+    for ( gindex = 0; gindex < face->num_glyphs; gindex++ )
+    {
+      FT_TS_Outline*  outline = &face->glyph->outline;
+      FT_TS_BBox      cbox;
+
+
+      if ( FT_TS_Load_Glyph( face, (FT_TS_UInt)gindex, FT_TS_LOAD_NO_BITMAP ) ||
+           face->glyph->format != FT_TS_GLYPH_FORMAT_OUTLINE               ||
+           outline->n_points == 0                                       )
+        continue;
+
+      if ( FT_TS_Outline_New( library,
+                           (FT_TS_UInt)outline->n_points,
+                           outline->n_contours,
+                           &glyphs[count].outline ) )
+        break;
+
+      FT_TS_Outline_Copy( outline, &glyphs[count].outline );
+
+      FT_TS_Outline_Get_CBox( outline, &cbox );
+      cbox.xMin &= ~63;
+      cbox.yMin &= ~63;
+      cbox.xMax  = ( cbox.xMax + 63 ) & ~63;
+      cbox.yMax  = ( cbox.yMax + 63 ) & ~63;
+
+      FT_TS_Outline_Translate( &glyphs[count].outline, -cbox.xMin, -cbox.yMin );
+
+      setup_bitmap( &glyphs[count].gray, &cbox, FT_TS_PIXEL_MODE_GRAY );
+      setup_bitmap( &glyphs[count].mono, &cbox, FT_TS_PIXEL_MODE_MONO );
+
+      count++;
+    }
+
+    printf( "%s: %d outline glyphs at %d pixels, %ld passes\n",
+            argv[1], count, size, repeat );
+
+    profile_render( library, glyphs, count, repeat );
+
+    for ( i = 0; i < count; i++ )
+    {
+      FT_TS_Outline_Done( library, &glyphs[i].outline );
+      free( glyphs[i].gray.buffer );
+      free( glyphs[i].mono.buffer );
+    }
+    free( glyphs );
+
+    FT_TS_Done_Face( face );
+    FT_TS_Done_FreeType( library );
+
+    return 0;
+  }
+
+
+/* END */
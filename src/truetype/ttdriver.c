@@ -108,6 +108,28 @@
       return error;
     }
 
+    if ( !ft_strcmp( property_name, "sbit-atlas-limit" ) )
+    {
+#ifdef FT_TS_CONFIG_OPTION_ENVIRONMENT_PROPERTIES
+      if ( value_is_string )
+      {
+        const char*  s = (const char*)value;
+
+
+        driver->sbit_atlas_limit = (FT_TS_ULong)ft_strtol( s, NULL, 10 );
+      }
+      else
+#endif
+      {
+        FT_TS_ULong*  limit = (FT_TS_ULong*)value;
+
+
+        driver->sbit_atlas_limit = *limit;
+      }
+
+      return error;
+    }
+
     FT_TS_TRACE2(( "tt_property_set: missing property `%s'\n",
                 property_name ));
     return FT_TS_THROW( Missing_Property );
@@ -135,6 +157,16 @@
       return error;
     }
 
+    if ( !ft_strcmp( property_name, "sbit-atlas-limit" ) )
+    {
+      FT_TS_ULong*  val = (FT_TS_ULong*)value;
+
+
+      *val = driver->sbit_atlas_limit;
+
+      return error;
+    }
+
     FT_TS_TRACE2(( "tt_property_get: missing property `%s'\n",
                 property_name ));
     return FT_TS_THROW( Missing_Property );
@@ -1111,11 +1111,8 @@
         else
 #endif /* TT_CONFIG_OPTION_GX_VAR_SUPPORT */
         {
-          for ( ; vec < limit; vec++ )
-          {
-            vec->x = FT_TS_MulFix( vec->x, x_scale );
-            vec->y = FT_TS_MulFix( vec->y, y_scale );
-          }
+          FT_TS_Vectors_Scale( vec, (FT_TS_UInt)( limit - vec ),
+                            x_scale, y_scale );
         }
       }
 
@@ -2383,6 +2380,9 @@
     sfnt   = (SFNT_Service)face->sfnt;
     stream = face->root.stream;
 
+    face->sbit_atlas_limit =
+      ( (TT_Driver)FT_TS_FACE_DRIVER( face ) )->sbit_atlas_limit;
+
     error = sfnt->load_sbit_image( face,
                                    size->strike_index,
                                    glyph_index,
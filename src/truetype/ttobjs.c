@@ -1466,10 +1466,12 @@
   FT_TS_LOCAL_DEF( FT_TS_Error )
   tt_driver_init( FT_TS_Module  ttdriver )     /* TT_Driver */
   {
+    TT_Driver  driver = (TT_Driver)ttdriver;
 
-#ifdef TT_USE_BYTECODE_INTERPRETER
 
-    TT_Driver  driver = (TT_Driver)ttdriver;
+    driver->sbit_atlas_limit = 0;
+
+#ifdef TT_USE_BYTECODE_INTERPRETER
 
     driver->interpreter_version = TT_INTERPRETER_VERSION_35;
 #ifdef TT_SUPPORT_SUBPIXEL_HINTING_INFINALITY
@@ -1479,11 +1481,7 @@
     driver->interpreter_version = TT_INTERPRETER_VERSION_40;
 #endif
 
-#else /* !TT_USE_BYTECODE_INTERPRETER */
-
-    FT_TS_UNUSED( ttdriver );
-
-#endif /* !TT_USE_BYTECODE_INTERPRETER */
+#endif /* TT_USE_BYTECODE_INTERPRETER */
 
     return FT_TS_Err_Ok;
   }
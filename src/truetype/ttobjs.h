@@ -337,6 +337,8 @@ FT_TS_BEGIN_HEADER
 
     FT_TS_UInt  interpreter_version;
 
+    FT_TS_ULong  sbit_atlas_limit;  /* see `ttsbit.c' */
+
   } TT_DriverRec;
 
 
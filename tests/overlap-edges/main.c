@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <freetype/freetype.h>
+#include <freetype/ftoutln.h>
+#include <ft2build.h>
+
+
+/*
+ * A hexagon and a triangle with the same orientation, overlapping near
+ * a nearly horizontal edge of the triangle.  The rasterizer must remove
+ * the overlap; the coverage is compared with a supersampled reference.
+ */
+
+static FT_TS_Vector  points[] =
+{
+  { 1433, 2644 }, { 1643, 2886 }, { 1957, 2825 },
+  { 2062, 2523 }, { 1852, 2281 }, { 1538, 2342 },
+  { 2378, 2284 }, { 1491, 2283 }, { 1934, 3051 }
+};
+
+static short  contours[] = { 5, 8 };
+
+#define SIZE     64
+#define SAMPLES  16
+
+
+/* the non-zero winding number at (`x`,`y`) in 26.6 units */
+static int
+winding( double  x,
+         double  y )
+{
+  int  w     = 0;
+  int  first = 0;
+  int  c, i, n;
+
+
+  for ( c = 0; c < 2; c++ )
+  {
+    n = contours[c] + 1 - first;
+
+    for ( i = 0; i < n; i++ )
+    {
+      FT_TS_Vector*  a  = points + first + i;
+      FT_TS_Vector*  b  = points + first + ( i + 1 ) % n;
+      double        ya = a->y;
+      double        yb = b->y;
+
+
+      if ( ( ya <= y ) != ( yb <= y ) &&
+           a->x + ( y - ya ) / ( yb - ya ) * ( b->x - a->x ) < x )
+        w += yb > ya ? 1 : -1;
+    }
+
+    first = contours[c] + 1;
+  }
+
+  return w;
+}
+
+
+int
+main( void )
+{
+  FT_TS_Library  library;
+  FT_TS_Outline  outline;
+  FT_TS_Bitmap   bitmap;
+  char           tags[9];
+  unsigned char  buffer[SIZE * SIZE];
+  int            x, y, i, j;
+  int            failed = 0;
+
+
+  memset( tags, FT_TS_CURVE_TAG_ON, sizeof ( tags ) );
+  memset( buffer, 0, sizeof ( buffer ) );
+
+  outline.n_contours = 2;
+  outline.n_points   = 9;
+  outline.points     = points;
+  outline.tags       = tags;
+  outline.contours   = contours;
+  outline.flags      = FT_TS_OUTLINE_OVERLAP;
+
+  memset( &bitmap, 0, sizeof ( bitmap ) );
+  bitmap.rows       = SIZE;
+  bitmap.width      = SIZE;
+  bitmap.pitch      = SIZE;
+  bitmap.buffer     = buffer;
+  bitmap.num_grays  = 256;
+  bitmap.pixel_mode = FT_TS_PIXEL_MODE_GRAY;
+
+  if ( FT_TS_Init_FreeType( &library )                     ||
+       FT_TS_Outline_Get_Bitmap( library, &outline, &bitmap ) )
+  {
+    fprintf( stderr, "Could not render the outline\n" );
+    return 1;
+  }
+
+  for ( y = 0; y < SIZE; y++ )
+    for ( x = 0; x < SIZE; x++ )
+    {
+      int  covered = 0;
+      int  ref, value;
+
+
+      for ( i = 0; i < SAMPLES; i++ )
+        for ( j = 0; j < SAMPLES; j++ )
+          if ( winding( ( x + ( i + 0.5 ) / SAMPLES ) * 64,
+                        ( y + ( j + 0.5 ) / SAMPLES ) * 64 ) )
+            covered++;
+
+      ref   = covered * 255 / ( SAMPLES * SAMPLES );
+      value = buffer[( SIZE - 1 - y ) * SIZE + x];
+
+      if ( abs( value - ref ) > 24 )
+      {
+        printf( "pixel (%d,%d): coverage %d, expected %d\n",
+                x, y, value, ref );
+        failed = 1;
+      }
+    }
+
+  FT_TS_Done_FreeType( library );
+
+  return failed;
+}
+
+/* EOF */
@@ -0,0 +1,558 @@
+/****************************************************************************
+ *
+ * ftcanvas.h
+ *
+ *   FreeType glyph rendering into client surfaces (specification).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#ifndef FTCANVAS_H_
+#define FTCANVAS_H_
+
+
+#include <freetype/freetype.h>
+#include <freetype/ftcolor.h>
+
+
+FT_TS_BEGIN_HEADER
+
+
+  /**************************************************************************
+   *
+   * @section:
+   *   canvas_rendering
+   *
+   * @title:
+   *   Canvas Rendering
+   *
+   * @abstract:
+   *   Rendering glyphs directly into a client surface.
+   *
+   * @description:
+   *   The functions of this section composite glyphs into a surface owned
+   *   by the client, called a `canvas`, without going through
+   *   `slot->bitmap`.  Outlines are rendered with the anti-aliasing
+   *   rasterizer in direct mode (@FT_TS_RASTER_FLAG_DIRECT), blending each
+   *   span into the canvas as soon as it is produced; bitmap glyphs
+   *   (embedded bitmaps, or bitmaps already processed by
+   *   @FT_TS_Bitmap_Load_Glyph and friends) are blended from the glyph
+   *   slot.
+   *
+   *   Glyph coverage is used as a mask for a single color.  No gamma
+   *   correction is applied.
+   *
+   *   Glyphs too large for a single bitmap can be rendered in tiles of a
+   *   fixed size with @FT_TS_Render_Glyph_Tiles, handing each tile to a
+   *   client callback.  Whole pages of monochrome glyphs, as needed for
+   *   printing, can be rendered in horizontal bands of a page with
+   *   @FT_TS_Render_Page_Bands.
+   *
+   * @order:
+   *   FT_TS_Canvas_Format
+   *   FT_TS_CanvasRec
+   *   FT_TS_Canvas
+   *
+   *   FT_TS_Canvas_Render_Outline
+   *   FT_TS_Canvas_Draw_Bitmap
+   *   FT_TS_Canvas_Render_Glyph
+   *
+   *   FT_TS_Tile_Func
+   *   FT_TS_Render_Glyph_Tiles
+   *
+   *   FT_TS_Page_GlyphRec
+   *   FT_TS_PageRec
+   *   FT_TS_Band_Func
+   *   FT_TS_Render_Page_Bands
+   *
+   */
+
+
+  /**************************************************************************
+   *
+   * @enum:
+   *   FT_TS_Canvas_Format
+   *
+   * @description:
+   *   An enumeration of the pixel formats supported by canvases.
+   *
+   * @values:
+   *   FT_TS_CANVAS_FORMAT_NONE ::
+   *     Value~0 is reserved.
+   *
+   *   FT_TS_CANVAS_FORMAT_A8 ::
+   *     An 8-bit alpha channel, one byte per pixel.  Glyphs are composited
+   *     with the `over` operator, using the color's alpha value only.
+   *
+   *   FT_TS_CANVAS_FORMAT_BGRA32 ::
+   *     32-bit pixels with premultiplied alpha, stored as blue, green, red,
+   *     and alpha bytes.  Glyphs are composited with the `over` operator.
+   *
+   *   FT_TS_CANVAS_FORMAT_RGB24 ::
+   *     24-bit pixels without alpha channel, stored as red, green, and
+   *     blue bytes.  The glyph color is interpolated with the background.
+   */
+  typedef enum  FT_TS_Canvas_Format_
+  {
+    FT_TS_CANVAS_FORMAT_NONE = 0,
+    FT_TS_CANVAS_FORMAT_A8,
+    FT_TS_CANVAS_FORMAT_BGRA32,
+    FT_TS_CANVAS_FORMAT_RGB24,
+
+    FT_TS_CANVAS_FORMAT_MAX      /* do not remove */
+
+  } FT_TS_Canvas_Format;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_TS_CanvasRec
+   *
+   * @description:
+   *   A structure describing a client surface to draw glyphs into.
+   *
+   * @fields:
+   *   buffer ::
+   *     A typeless pointer to the top row of the surface.
+   *
+   *   width ::
+   *     The surface width in pixels.
+   *
+   *   rows ::
+   *     The surface height in pixels.
+   *
+   *   pitch ::
+   *     The number of bytes to add to go from one row to the next one
+   *     below.  It can be negative for bottom-up surfaces.
+   *
+   *   format ::
+   *     The pixel format, see @FT_TS_Canvas_Format.
+   *
+   *   clip ::
+   *     A clipping rectangle in integer pixel coordinates, with the origin
+   *     at the top left corner of the surface and the y~axis pointing
+   *     down.  `xMax` and `yMax` are exclusive.  The rectangle is
+   *     intersected with the surface; if all fields are zero, the whole
+   *     surface is used.
+   *
+   *   color ::
+   *     The glyph color, not premultiplied.  Only the `alpha` field is
+   *     used for @FT_TS_CANVAS_FORMAT_A8 canvases.  Color bitmaps
+   *     (@FT_TS_PIXEL_MODE_BGRA) keep their own colors and are only faded
+   *     by `alpha`.
+   */
+  typedef struct  FT_TS_CanvasRec_
+  {
+    unsigned char*       buffer;
+    FT_TS_Int            width;
+    FT_TS_Int            rows;
+    FT_TS_Int            pitch;
+    FT_TS_Canvas_Format  format;
+
+    FT_TS_BBox           clip;
+    FT_TS_Color          color;
+
+  } FT_TS_CanvasRec;
+
+
+  /**************************************************************************
+   *
+   * @type:
+   *   FT_TS_Canvas
+   *
+   * @description:
+   *   A handle to a @FT_TS_CanvasRec structure.
+   */
+  typedef FT_TS_CanvasRec*  FT_TS_Canvas;
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Canvas_Render_Outline
+   *
+   * @description:
+   *   Render an outline directly into a canvas.
+   *
+   * @input:
+   *   library ::
+   *     A handle to a FreeType library object.
+   *
+   *   canvas ::
+   *     A handle to the target canvas.
+   *
+   *   x ::
+   *     The horizontal canvas position of the outline's origin.
+   *
+   *   y ::
+   *     The vertical canvas position of the outline's origin, usually the
+   *     baseline.
+   *
+   * @inout:
+   *   outline ::
+   *     A pointer to the source outline, in 26.6 pixel coordinates with the
+   *     y~axis pointing up.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The outline is translated during rendering and restored afterwards.
+   *   It is always rendered with anti-aliasing, whatever its flags; the
+   *   coverage values are the same as with @FT_TS_Render_Glyph in
+   *   @FT_TS_RENDER_MODE_NORMAL, except for even-odd outlines with the
+   *   @FT_TS_OUTLINE_OVERLAP flag, which are not oversampled.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Canvas_Render_Outline( FT_TS_Library   library,
+                               FT_TS_Canvas    canvas,
+                               FT_TS_Outline*  outline,
+                               FT_TS_Int       x,
+                               FT_TS_Int       y );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Canvas_Draw_Bitmap
+   *
+   * @description:
+   *   Composite a bitmap into a canvas.
+   *
+   * @input:
+   *   canvas ::
+   *     A handle to the target canvas.
+   *
+   *   bitmap ::
+   *     A handle to the source bitmap.  Pixel modes @FT_TS_PIXEL_MODE_MONO,
+   *     @FT_TS_PIXEL_MODE_GRAY, @FT_TS_PIXEL_MODE_GRAY2,
+   *     @FT_TS_PIXEL_MODE_GRAY4, and @FT_TS_PIXEL_MODE_BGRA are supported.
+   *
+   *   x ::
+   *     The horizontal canvas position of the bitmap's left edge.
+   *
+   *   y ::
+   *     The vertical canvas position of the bitmap's top edge.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Canvas_Draw_Bitmap( FT_TS_Canvas         canvas,
+                            const FT_TS_Bitmap*  bitmap,
+                            FT_TS_Int            x,
+                            FT_TS_Int            y );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Canvas_Render_Glyph
+   *
+   * @description:
+   *   Draw the glyph image of a glyph slot into a canvas.
+   *
+   * @input:
+   *   canvas ::
+   *     A handle to the target canvas.
+   *
+   *   slot ::
+   *     A handle to the glyph slot, as filled by @FT_TS_Load_Glyph.
+   *
+   *   x ::
+   *     The horizontal canvas position of the pen.
+   *
+   *   y ::
+   *     The vertical canvas position of the pen, usually the baseline.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Outlines are rendered as with @FT_TS_Canvas_Render_Outline, never
+   *   creating `slot->bitmap`.  Bitmaps are drawn at the position given
+   *   by `bitmap_left` and `bitmap_top`.  Other glyph formats are first
+   *   rendered with @FT_TS_Render_Glyph in @FT_TS_RENDER_MODE_NORMAL.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Canvas_Render_Glyph( FT_TS_Canvas     canvas,
+                             FT_TS_GlyphSlot  slot,
+                             FT_TS_Int        x,
+                             FT_TS_Int        y );
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FT_TS_Tile_Func
+   *
+   * @description:
+   *   A function used as a callback by @FT_TS_Render_Glyph_Tiles to hand a
+   *   rendered tile to the client.
+   *
+   * @input:
+   *   tile ::
+   *     The tile bitmap.  Its buffer is owned by FreeType and reused for
+   *     the next tile.
+   *
+   *   left ::
+   *     The tile's left-side bearing, i.e., the horizontal distance from
+   *     the glyph origin to the leftmost tile pixel column.  This is the
+   *     same convention as for `bitmap_left` in @FT_TS_GlyphSlotRec.
+   *
+   *   top ::
+   *     The tile's top-side bearing, i.e., the vertical distance from the
+   *     glyph origin to the top tile pixel row, upwards y~coordinates being
+   *     positive.  This is the same convention as for `bitmap_top` in
+   *     @FT_TS_GlyphSlotRec.
+   *
+   *   user ::
+   *     User-supplied data passed to @FT_TS_Render_Glyph_Tiles.
+   *
+   * @return:
+   *   Error code.  A non-zero value stops rendering and is returned by
+   *   @FT_TS_Render_Glyph_Tiles.
+   */
+  typedef FT_TS_Error
+  (*FT_TS_Tile_Func)( const FT_TS_Bitmap*  tile,
+                      FT_TS_Int            left,
+                      FT_TS_Int            top,
+                      void*                user );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Render_Glyph_Tiles
+   *
+   * @description:
+   *   Render the outline of a glyph slot in tiles of a fixed size, without
+   *   ever allocating a bitmap for the whole glyph.
+   *
+   * @input:
+   *   slot ::
+   *     A handle to a glyph slot containing an outline.
+   *
+   *   render_mode ::
+   *     @FT_TS_RENDER_MODE_NORMAL, @FT_TS_RENDER_MODE_LIGHT, or
+   *     @FT_TS_RENDER_MODE_MONO.
+   *
+   *   tile_width ::
+   *     The tile width in pixels.  Value~0 means the width of the glyph,
+   *     i.e., the glyph is rendered in horizontal bands.
+   *
+   *   tile_height ::
+   *     The tile height in pixels.  Must not be zero.
+   *
+   *   func ::
+   *     The callback receiving the tiles.  Tiles are produced row by row,
+   *     from top to bottom and left to right.  Tiles at the right and
+   *     bottom edges of the glyph are smaller; tiles without any inked
+   *     pixel are skipped.
+   *
+   *   user ::
+   *     User data passed to `func`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   The tiles cover the same pixel box as `slot->bitmap` would after a
+   *   call to @FT_TS_Render_Glyph, which is left untouched.  Unlike
+   *   @FT_TS_Render_Glyph, this function also accepts glyphs whose box
+   *   exceeds 32767 pixels in either direction.  Memory use depends on
+   *   the tile size and the number of outline points, but not on the
+   *   glyph size.  Each tile is only rendered from the contours close to
+   *   it.
+   *
+   *   In @FT_TS_RENDER_MODE_NORMAL and @FT_TS_RENDER_MODE_LIGHT, the tiles
+   *   are identical to the corresponding parts of the whole glyph bitmap
+   *   (outlines with the @FT_TS_OUTLINE_OVERLAP flag are not oversampled,
+   *   though).  For glyphs wider than 32767 pixels, gray levels can
+   *   differ slightly at tile borders.
+   *   In @FT_TS_RENDER_MODE_MONO, drop-out pixels next to tile borders can
+   *   differ since drop-out control is restricted to each tile.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Render_Glyph_Tiles( FT_TS_GlyphSlot    slot,
+                            FT_TS_Render_Mode  render_mode,
+                            FT_TS_UInt         tile_width,
+                            FT_TS_UInt         tile_height,
+                            FT_TS_Tile_Func    func,
+                            void*              user );
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_TS_Page_GlyphRec
+   *
+   * @description:
+   *   A structure describing a glyph positioned on a page, to be used
+   *   with @FT_TS_Render_Page_Bands.
+   *
+   * @fields:
+   *   outline ::
+   *     A pointer to the glyph's outline, in 26.6 pixel coordinates with
+   *     the y~axis pointing up.  If NULL, `glyph_index` is loaded from the
+   *     page's face instead.
+   *
+   *   glyph_index ::
+   *     The glyph index, only used if `outline` is NULL.
+   *
+   *   x ::
+   *     The horizontal page position of the glyph origin.
+   *
+   *   y ::
+   *     The vertical page position of the glyph origin, usually the
+   *     baseline.  Page rows are counted from the top.
+   */
+  typedef struct  FT_TS_Page_GlyphRec_
+  {
+    FT_TS_Outline*  outline;
+    FT_TS_UInt      glyph_index;
+    FT_TS_Int       x;
+    FT_TS_Int       y;
+
+  } FT_TS_Page_GlyphRec;
+
+
+  /**************************************************************************
+   *
+   * @struct:
+   *   FT_TS_PageRec
+   *
+   * @description:
+   *   A structure describing a page of glyphs to be rendered with
+   *   @FT_TS_Render_Page_Bands.
+   *
+   * @fields:
+   *   face ::
+   *     The face used to load glyphs given by index.  Can be NULL if all
+   *     glyphs have an outline.
+   *
+   *   load_flags ::
+   *     The load flags for glyphs given by index.
+   *     @FT_TS_LOAD_NO_BITMAP is always added.
+   *
+   *   rows ::
+   *     The page height in pixels.  The page width is the width of the band
+   *     bitmap.
+   *
+   *   glyphs ::
+   *     An array of `num_glyphs` positioned glyphs, in any order.
+   *
+   *   num_glyphs ::
+   *     The number of glyphs on the page.
+   */
+  typedef struct  FT_TS_PageRec_
+  {
+    FT_TS_Face                  face;
+    FT_TS_Int32                 load_flags;
+    FT_TS_UInt                  rows;
+
+    const FT_TS_Page_GlyphRec*  glyphs;
+    FT_TS_UInt                  num_glyphs;
+
+  } FT_TS_PageRec;
+
+
+  /**************************************************************************
+   *
+   * @functype:
+   *   FT_TS_Band_Func
+   *
+   * @description:
+   *   A function used as a callback by @FT_TS_Render_Page_Bands to hand a
+   *   rendered band to the client.
+   *
+   * @input:
+   *   band ::
+   *     The band bitmap.  It uses the buffer given to
+   *     @FT_TS_Render_Page_Bands; only the number of rows of the last band
+   *     can be smaller.
+   *
+   *   top ::
+   *     The page row of the band's top row.
+   *
+   *   user ::
+   *     User-supplied data passed to @FT_TS_Render_Page_Bands.
+   *
+   * @return:
+   *   Error code.  A non-zero value stops rendering and is returned by
+   *   @FT_TS_Render_Page_Bands.
+   */
+  typedef FT_TS_Error
+  (*FT_TS_Band_Func)( const FT_TS_Bitmap*  band,
+                      FT_TS_Int            top,
+                      void*                user );
+
+
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Render_Page_Bands
+   *
+   * @description:
+   *   Render a page of glyphs with the monochrome rasterizer, band by band,
+   *   without ever allocating a bitmap for the whole page.
+   *
+   * @input:
+   *   library ::
+   *     A handle to a FreeType library object.
+   *
+   *   page ::
+   *     The page to render.
+   *
+   *   band ::
+   *     An @FT_TS_PIXEL_MODE_MONO bitmap whose buffer receives the bands in
+   *     turn.  Its width is the page width and its number of rows the band
+   *     height.  The pitch must be positive.
+   *
+   *   func ::
+   *     The callback receiving the bands, from the top of the page to the
+   *     bottom.
+   *
+   *   user ::
+   *     User data passed to `func`.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   Glyphs are rendered as with @FT_TS_Render_Glyph in
+   *   @FT_TS_RENDER_MODE_MONO and combined with a logical `or`.  Each
+   *   glyph is rasterized only once, even if it straddles bands: a glyph
+   *   starting in a band but ending in a later one is kept as a small
+   *   bitmap until its last row has been copied.  Glyph outlines given by
+   *   index are loaded once per page.
+   *
+   *   Glyphs without outline are ignored.  Outlines are translated during
+   *   rendering and restored afterwards.
+   */
+  FT_TS_EXPORT( FT_TS_Error )
+  FT_TS_Render_Page_Bands( FT_TS_Library         library,
+                           const FT_TS_PageRec*  page,
+                           FT_TS_Bitmap*         band,
+                           FT_TS_Band_Func       func,
+                           void*                 user );
+
+  /* */
+
+
+FT_TS_END_HEADER
+
+#endif /* FTCANVAS_H_ */
+
+
+/* END */
@@ -56,6 +56,7 @@ FT_TS_BEGIN_HEADER
    *   FT_TS_Outline_Copy
    *   FT_TS_Outline_Translate
    *   FT_TS_Outline_Transform
+   *   FT_TS_Outline_Transform_Translate
    *   FT_TS_Outline_Embolden
    *   FT_TS_Outline_EmboldenXY
    *   FT_TS_Outline_Reverse
@@ -327,6 +328,40 @@ FT_TS_BEGIN_HEADER
                         const FT_TS_Matrix*   matrix );
 
 
+  /**************************************************************************
+   *
+   * @function:
+   *   FT_TS_Outline_Transform_Translate
+   *
+   * @description:
+   *   Apply a 2x2 matrix and then a translation to all of an outline's
+   *   points in a single pass.  The result is the same as calling
+   *   @FT_TS_Outline_Transform and then @FT_TS_Outline_Translate.
+   *
+   * @inout:
+   *   outline ::
+   *     A pointer to the target outline descriptor.
+   *
+   * @input:
+   *   matrix ::
+   *     A pointer to the transformation matrix.  If NULL, the identity
+   *     matrix is used.
+   *
+   *   delta ::
+   *     A pointer to the translation vector.  If NULL, no translation is
+   *     applied.
+   *
+   * @note:
+   *   Scalings and rotations by multiples of 90~degrees, including the
+   *   flips used for right-to-left and top-to-bottom layout, are handled
+   *   by faster code paths.
+   */
+  FT_TS_EXPORT( void )
+  FT_TS_Outline_Transform_Translate( const FT_TS_Outline*  outline,
+                                  const FT_TS_Matrix*   matrix,
+                                  const FT_TS_Vector*   delta );
+
+
   /**************************************************************************
    *
    * @function:
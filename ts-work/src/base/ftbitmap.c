@@ -199,141 +199,382 @@
   }
 
 
-  /* documentation is in ftbitmap.h */
+  /*
+   * The conversion of whole source rows can process a block of pixels at
+   * once with SSE2 instructions, which are always available on x86_64.
+   * The pixels at the end of each row are converted by the scalar code.
+   */
+#if defined( __SSE2__ )                          || \
+    defined( __x86_64__ )                        || \
+    defined( _M_AMD64 )                          || \
+    ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  define FT_TS_BITMAP_SIMD  1
+#  include <emmintrin.h>
+#else
+#  define FT_TS_BITMAP_SIMD  0
+#endif
+
+
+  /* Convert a row of `width' 1bpp pixels to one byte per pixel. */
+  static void
+  ft_bitmap_convert_mono( const FT_TS_Byte*  ss,
+                          FT_TS_Byte*        tt,
+                          FT_TS_UInt         width )
+  {
+    FT_TS_UInt  j = width >> 3;
 
-  FT_TS_EXPORT_DEF( FT_TS_Error )
-  FT_TS_Bitmap_Convert( FT_TS_Library        library,
-                     const FT_TS_Bitmap  *source,
-                     FT_TS_Bitmap        *target,
-                     FT_TS_Int            alignment )
+
+#if FT_TS_BITMAP_SIMD
+
+    /* split 16 source bytes into bit planes, then interleave the */
+    /* planes to get the bits of every byte in order              */
+    {
+      const __m128i  one = _mm_set1_epi8( 1 );
+
+
+      for ( ; j >= 16; j -= 16, ss += 16, tt += 128 )
+      {
+        __m128i  x = _mm_loadu_si128( (const __m128i*)ss );
+        __m128i  p[8], a, b, c, d, ab, cd;
+        int      k, h;
+
+
+        for ( k = 0; k < 8; k++ )
+          p[k] = _mm_and_si128( _mm_srli_epi16( x, 7 - k ), one );
+
+        for ( h = 0; h < 2; h++ )
+        {
+          if ( h == 0 )
+          {
+            a = _mm_unpacklo_epi8( p[0], p[1] );
+            b = _mm_unpacklo_epi8( p[2], p[3] );
+            c = _mm_unpacklo_epi8( p[4], p[5] );
+            d = _mm_unpacklo_epi8( p[6], p[7] );
+          }
+          else
+          {
+            a = _mm_unpackhi_epi8( p[0], p[1] );
+            b = _mm_unpackhi_epi8( p[2], p[3] );
+            c = _mm_unpackhi_epi8( p[4], p[5] );
+            d = _mm_unpackhi_epi8( p[6], p[7] );
+          }
+
+          ab = _mm_unpacklo_epi16( a, b );
+          cd = _mm_unpacklo_epi16( c, d );
+          _mm_storeu_si128( (__m128i*)( tt + 64 * h ),
+                            _mm_unpacklo_epi32( ab, cd ) );
+          _mm_storeu_si128( (__m128i*)( tt + 64 * h + 16 ),
+                            _mm_unpackhi_epi32( ab, cd ) );
+
+          ab = _mm_unpackhi_epi16( a, b );
+          cd = _mm_unpackhi_epi16( c, d );
+          _mm_storeu_si128( (__m128i*)( tt + 64 * h + 32 ),
+                            _mm_unpacklo_epi32( ab, cd ) );
+          _mm_storeu_si128( (__m128i*)( tt + 64 * h + 48 ),
+                            _mm_unpackhi_epi32( ab, cd ) );
+        }
+      }
+    }
+
+#endif /* FT_TS_BITMAP_SIMD */
+
+    /* get the full bytes */
+    for ( ; j > 0; j-- )
+    {
+      FT_TS_Int  val = ss[0]; /* avoid a byte->int cast on each line */
+
+
+      tt[0] = (FT_TS_Byte)( ( val & 0x80 ) >> 7 );
+      tt[1] = (FT_TS_Byte)( ( val & 0x40 ) >> 6 );
+      tt[2] = (FT_TS_Byte)( ( val & 0x20 ) >> 5 );
+      tt[3] = (FT_TS_Byte)( ( val & 0x10 ) >> 4 );
+      tt[4] = (FT_TS_Byte)( ( val & 0x08 ) >> 3 );
+      tt[5] = (FT_TS_Byte)( ( val & 0x04 ) >> 2 );
+      tt[6] = (FT_TS_Byte)( ( val & 0x02 ) >> 1 );
+      tt[7] = (FT_TS_Byte)(   val & 0x01 );
+
+      tt += 8;
+      ss += 1;
+    }
+
+    /* get remaining pixels (if any) */
+    j = width & 7;
+    if ( j > 0 )
+    {
+      FT_TS_Int  val = *ss;
+
+
+      for ( ; j > 0; j-- )
+      {
+        tt[0] = (FT_TS_Byte)( ( val & 0x80 ) >> 7);
+        val <<= 1;
+        tt   += 1;
+      }
+    }
+  }
+
+
+  /* Convert a row of `width' 2bpp pixels to one byte per pixel. */
+  static void
+  ft_bitmap_convert_gray2( const FT_TS_Byte*  ss,
+                           FT_TS_Byte*        tt,
+                           FT_TS_UInt         width )
   {
-    FT_TS_Error   error = FT_TS_Err_Ok;
-    FT_TS_Memory  memory;
+    FT_TS_UInt  j = width >> 2;
 
-    FT_TS_Byte*  s;
-    FT_TS_Byte*  t;
 
+#if FT_TS_BITMAP_SIMD
 
-    if ( !library )
-      return FT_TS_THROW( Invalid_Library_Handle );
+    {
+      const __m128i  three = _mm_set1_epi8( 3 );
 
-    if ( !source || !target )
-      return FT_TS_THROW( Invalid_Argument );
 
-    memory = library->memory;
+      for ( ; j >= 16; j -= 16, ss += 16, tt += 64 )
+      {
+        __m128i  x  = _mm_loadu_si128( (const __m128i*)ss );
+        __m128i  p0 = _mm_and_si128( _mm_srli_epi16( x, 6 ), three );
+        __m128i  p1 = _mm_and_si128( _mm_srli_epi16( x, 4 ), three );
+        __m128i  p2 = _mm_and_si128( _mm_srli_epi16( x, 2 ), three );
+        __m128i  p3 = _mm_and_si128( x, three );
+        __m128i  a, b;
+
+
+        a = _mm_unpacklo_epi8( p0, p1 );
+        b = _mm_unpacklo_epi8( p2, p3 );
+        _mm_storeu_si128( (__m128i*)tt,
+                          _mm_unpacklo_epi16( a, b ) );
+        _mm_storeu_si128( (__m128i*)( tt + 16 ),
+                          _mm_unpackhi_epi16( a, b ) );
+
+        a = _mm_unpackhi_epi8( p0, p1 );
+        b = _mm_unpackhi_epi8( p2, p3 );
+        _mm_storeu_si128( (__m128i*)( tt + 32 ),
+                          _mm_unpacklo_epi16( a, b ) );
+        _mm_storeu_si128( (__m128i*)( tt + 48 ),
+                          _mm_unpackhi_epi16( a, b ) );
+      }
+    }
 
-    switch ( source->pixel_mode )
+#endif /* FT_TS_BITMAP_SIMD */
+
+    /* get the full bytes */
+    for ( ; j > 0; j-- )
     {
-    case FT_TS_PIXEL_MODE_MONO:
-    case FT_TS_PIXEL_MODE_GRAY:
-    case FT_TS_PIXEL_MODE_GRAY2:
-    case FT_TS_PIXEL_MODE_GRAY4:
-    case FT_TS_PIXEL_MODE_LCD:
-    case FT_TS_PIXEL_MODE_LCD_V:
-    case FT_TS_PIXEL_MODE_BGRA:
+      FT_TS_Int  val = ss[0];
+
+
+      tt[0] = (FT_TS_Byte)( ( val & 0xC0 ) >> 6 );
+      tt[1] = (FT_TS_Byte)( ( val & 0x30 ) >> 4 );
+      tt[2] = (FT_TS_Byte)( ( val & 0x0C ) >> 2 );
+      tt[3] = (FT_TS_Byte)( ( val & 0x03 ) );
+
+      ss += 1;
+      tt += 4;
+    }
+
+    j = width & 3;
+    if ( j > 0 )
+    {
+      FT_TS_Int  val = ss[0];
+
+
+      for ( ; j > 0; j-- )
       {
-        FT_TS_Int    pad, old_target_pitch, target_pitch;
-        FT_TS_ULong  old_size;
+        tt[0]  = (FT_TS_Byte)( ( val & 0xC0 ) >> 6 );
+        val  <<= 2;
+        tt    += 1;
+      }
+    }
+  }
 
 
-        old_target_pitch = target->pitch;
-        if ( old_target_pitch < 0 )
-          old_target_pitch = -old_target_pitch;
+  /* Convert a row of `width' 4bpp pixels to one byte per pixel. */
+  static void
+  ft_bitmap_convert_gray4( const FT_TS_Byte*  ss,
+                           FT_TS_Byte*        tt,
+                           FT_TS_UInt         width )
+  {
+    FT_TS_UInt  j = width >> 1;
 
-        old_size = target->rows * (FT_TS_UInt)old_target_pitch;
 
-        target->pixel_mode = FT_TS_PIXEL_MODE_GRAY;
-        target->rows       = source->rows;
-        target->width      = source->width;
+#if FT_TS_BITMAP_SIMD
 
-        pad = 0;
-        if ( alignment > 0 )
-        {
-          pad = (FT_TS_Int)source->width % alignment;
-          if ( pad != 0 )
-            pad = alignment - pad;
-        }
+    {
+      const __m128i  mask = _mm_set1_epi8( 0x0F );
 
-        target_pitch = (FT_TS_Int)source->width + pad;
 
-        if ( target_pitch > 0                                               &&
-             (FT_TS_ULong)target->rows > FT_TS_ULONG_MAX / (FT_TS_ULong)target_pitch )
-          return FT_TS_THROW( Invalid_Argument );
+      for ( ; j >= 16; j -= 16, ss += 16, tt += 32 )
+      {
+        __m128i  x  = _mm_loadu_si128( (const __m128i*)ss );
+        __m128i  hi = _mm_and_si128( _mm_srli_epi16( x, 4 ), mask );
+        __m128i  lo = _mm_and_si128( x, mask );
 
-        if ( FT_TS_QREALLOC( target->buffer,
-                          old_size, target->rows * (FT_TS_UInt)target_pitch ) )
-          return error;
 
-        target->pitch = target->pitch < 0 ? -target_pitch : target_pitch;
+        _mm_storeu_si128( (__m128i*)tt,
+                          _mm_unpacklo_epi8( hi, lo ) );
+        _mm_storeu_si128( (__m128i*)( tt + 16 ),
+                          _mm_unpackhi_epi8( hi, lo ) );
       }
-      break;
+    }
 
-    default:
-      error = FT_TS_THROW( Invalid_Argument );
+#endif /* FT_TS_BITMAP_SIMD */
+
+    /* get the full bytes */
+    for ( ; j > 0; j-- )
+    {
+      FT_TS_Int  val = ss[0];
+
+
+      tt[0] = (FT_TS_Byte)( ( val & 0xF0 ) >> 4 );
+      tt[1] = (FT_TS_Byte)( ( val & 0x0F ) );
+
+      ss += 1;
+      tt += 2;
     }
 
-    s = source->buffer;
-    t = target->buffer;
+    if ( width & 1 )
+      tt[0] = (FT_TS_Byte)( ( ss[0] & 0xF0 ) >> 4 );
+  }
 
-    /* take care of bitmap flow */
-    if ( source->pitch < 0 )
-      s -= source->pitch * (FT_TS_Int)( source->rows - 1 );
-    if ( target->pitch < 0 )
-      t -= target->pitch * (FT_TS_Int)( target->rows - 1 );
 
-    switch ( source->pixel_mode )
+  /* Convert a row of `width' BGRA pixels to their gray values. */
+  static void
+  ft_bitmap_convert_bgra( const FT_TS_Byte*  ss,
+                          FT_TS_Byte*        tt,
+                          FT_TS_UInt         width )
+  {
+    FT_TS_UInt  j = width;
+
+
+#if FT_TS_BITMAP_SIMD
+
+    /*
+     * This is `ft_gray_for_premultiplied_srgb_bgra' for eight pixels at a
+     * time.  The squares fit into unsigned 16-bit lanes and their products
+     * with the coefficients are assembled from the low and high halves;
+     * the luminosity then fits into 16 bits, so the single-precision
+     * quotient `l / a' truncates to the exact integer quotient.
+     */
     {
-    case FT_TS_PIXEL_MODE_MONO:
-      {
-        FT_TS_UInt  i;
+      const __m128i  byte = _mm_set1_epi32( 0xFF );
+      const __m128i  cb   = _mm_set1_epi16( 4731 );
+      const __m128i  cg   = _mm_set1_epi16( (short)46868 );
+      const __m128i  cr   = _mm_set1_epi16( 13937 );
+      const __m128i  zero = _mm_setzero_si128();
+      const __m128i  one  = _mm_set1_epi32( 1 );
 
 
-        target->num_grays = 2;
+      for ( ; j >= 8; j -= 8, ss += 32, tt += 8 )
+      {
+        __m128i  v0 = _mm_loadu_si128( (const __m128i*)ss );
+        __m128i  v1 = _mm_loadu_si128( (const __m128i*)( ss + 16 ) );
+        __m128i  a0 = _mm_srli_epi32( v0, 24 );
+        __m128i  a1 = _mm_srli_epi32( v1, 24 );
+        __m128i  x, lo, hi, l0, l1, q0, q1;
+
+
+        /* blue */
+        x  = _mm_packs_epi32( _mm_and_si128( v0, byte ),
+                              _mm_and_si128( v1, byte ) );
+        x  = _mm_mullo_epi16( x, x );
+        lo = _mm_mullo_epi16( x, cb );
+        hi = _mm_mulhi_epu16( x, cb );
+        l0 = _mm_unpacklo_epi16( lo, hi );
+        l1 = _mm_unpackhi_epi16( lo, hi );
+
+        /* green */
+        x  = _mm_packs_epi32(
+               _mm_and_si128( _mm_srli_epi32( v0, 8 ), byte ),
+               _mm_and_si128( _mm_srli_epi32( v1, 8 ), byte ) );
+        x  = _mm_mullo_epi16( x, x );
+        lo = _mm_mullo_epi16( x, cg );
+        hi = _mm_mulhi_epu16( x, cg );
+        l0 = _mm_add_epi32( l0, _mm_unpacklo_epi16( lo, hi ) );
+        l1 = _mm_add_epi32( l1, _mm_unpackhi_epi16( lo, hi ) );
+
+        /* red */
+        x  = _mm_packs_epi32(
+               _mm_and_si128( _mm_srli_epi32( v0, 16 ), byte ),
+               _mm_and_si128( _mm_srli_epi32( v1, 16 ), byte ) );
+        x  = _mm_mullo_epi16( x, x );
+        lo = _mm_mullo_epi16( x, cr );
+        hi = _mm_mulhi_epu16( x, cr );
+        l0 = _mm_add_epi32( l0, _mm_unpacklo_epi16( lo, hi ) );
+        l1 = _mm_add_epi32( l1, _mm_unpackhi_epi16( lo, hi ) );
+
+        l0 = _mm_srli_epi32( l0, 16 );
+        l1 = _mm_srli_epi32( l1, 16 );
+
+        /* divide by one instead of zero; the result is masked anyway */
+        q0 = _mm_cvttps_epi32(
+               _mm_div_ps( _mm_cvtepi32_ps( l0 ),
+                           _mm_cvtepi32_ps(
+                             _mm_or_si128(
+                               a0,
+                               _mm_and_si128( _mm_cmpeq_epi32( a0, zero ),
+                                              one ) ) ) ) );
+        q1 = _mm_cvttps_epi32(
+               _mm_div_ps( _mm_cvtepi32_ps( l1 ),
+                           _mm_cvtepi32_ps(
+                             _mm_or_si128(
+                               a1,
+                               _mm_and_si128( _mm_cmpeq_epi32( a1, zero ),
+                                              one ) ) ) ) );
+
+        /* transparent pixels are zero */
+        q0 = _mm_andnot_si128( _mm_cmpeq_epi32( a0, zero ),
+                               _mm_and_si128( _mm_sub_epi32( a0, q0 ),
+                                              byte ) );
+        q1 = _mm_andnot_si128( _mm_cmpeq_epi32( a1, zero ),
+                               _mm_and_si128( _mm_sub_epi32( a1, q1 ),
+                                              byte ) );
+
+        x = _mm_packs_epi32( q0, q1 );
+        _mm_storel_epi64( (__m128i*)tt, _mm_packus_epi16( x, x ) );
+      }
+    }
 
-        for ( i = source->rows; i > 0; i-- )
-        {
-          FT_TS_Byte*  ss = s;
-          FT_TS_Byte*  tt = t;
-          FT_TS_UInt   j;
+#endif /* FT_TS_BITMAP_SIMD */
 
+    for ( ; j > 0; j-- )
+    {
+      tt[0] = ft_gray_for_premultiplied_srgb_bgra( ss );
 
-          /* get the full bytes */
-          for ( j = source->width >> 3; j > 0; j-- )
-          {
-            FT_TS_Int  val = ss[0]; /* avoid a byte->int cast on each line */
+      ss += 4;
+      tt += 1;
+    }
+  }
 
 
-            tt[0] = (FT_TS_Byte)( ( val & 0x80 ) >> 7 );
-            tt[1] = (FT_TS_Byte)( ( val & 0x40 ) >> 6 );
-            tt[2] = (FT_TS_Byte)( ( val & 0x20 ) >> 5 );
-            tt[3] = (FT_TS_Byte)( ( val & 0x10 ) >> 4 );
-            tt[4] = (FT_TS_Byte)( ( val & 0x08 ) >> 3 );
-            tt[5] = (FT_TS_Byte)( ( val & 0x04 ) >> 2 );
-            tt[6] = (FT_TS_Byte)( ( val & 0x02 ) >> 1 );
-            tt[7] = (FT_TS_Byte)(   val & 0x01 );
+  /* Convert the pixels of `source' into the buffer of `target', which */
+  /* has the same dimensions and a pitch of at least `source->width'.  */
+  static void
+  ft_bitmap_convert_pixels( const FT_TS_Bitmap*  source,
+                            FT_TS_Bitmap*        target )
+  {
+    FT_TS_Byte*  s = source->buffer;
+    FT_TS_Byte*  t = target->buffer;
+    FT_TS_UInt   width = source->width;
+    FT_TS_UInt   i;
 
-            tt += 8;
-            ss += 1;
-          }
 
-          /* get remaining pixels (if any) */
-          j = source->width & 7;
-          if ( j > 0 )
-          {
-            FT_TS_Int  val = *ss;
+    /* take care of bitmap flow */
+    if ( source->pitch < 0 )
+      s -= source->pitch * (FT_TS_Int)( source->rows - 1 );
+    if ( target->pitch < 0 )
+      t -= target->pitch * (FT_TS_Int)( target->rows - 1 );
 
+    switch ( source->pixel_mode )
+    {
+    case FT_TS_PIXEL_MODE_MONO:
+      target->num_grays = 2;
 
-            for ( ; j > 0; j-- )
-            {
-              tt[0] = (FT_TS_Byte)( ( val & 0x80 ) >> 7);
-              val <<= 1;
-              tt   += 1;
-            }
-          }
+      for ( i = source->rows; i > 0; i-- )
+      {
+        ft_bitmap_convert_mono( s, t, width );
 
-          s += source->pitch;
-          t += target->pitch;
-        }
+        s += source->pitch;
+        t += target->pitch;
       }
       break;
 
@@ -341,144 +582,181 @@
     case FT_TS_PIXEL_MODE_GRAY:
     case FT_TS_PIXEL_MODE_LCD:
     case FT_TS_PIXEL_MODE_LCD_V:
+      target->num_grays = 256;
+
+      for ( i = source->rows; i > 0; i-- )
       {
-        FT_TS_UInt  width = source->width;
-        FT_TS_UInt  i;
+        FT_TS_ARRAY_COPY( t, s, width );
 
+        s += source->pitch;
+        t += target->pitch;
+      }
+      break;
 
-        target->num_grays = 256;
 
-        for ( i = source->rows; i > 0; i-- )
-        {
-          FT_TS_ARRAY_COPY( t, s, width );
+    case FT_TS_PIXEL_MODE_GRAY2:
+      target->num_grays = 4;
 
-          s += source->pitch;
-          t += target->pitch;
-        }
+      for ( i = source->rows; i > 0; i-- )
+      {
+        ft_bitmap_convert_gray2( s, t, width );
+
+        s += source->pitch;
+        t += target->pitch;
       }
       break;
 
 
-    case FT_TS_PIXEL_MODE_GRAY2:
+    case FT_TS_PIXEL_MODE_GRAY4:
+      target->num_grays = 16;
+
+      for ( i = source->rows; i > 0; i-- )
       {
-        FT_TS_UInt  i;
+        ft_bitmap_convert_gray4( s, t, width );
 
+        s += source->pitch;
+        t += target->pitch;
+      }
+      break;
 
-        target->num_grays = 4;
 
-        for ( i = source->rows; i > 0; i-- )
-        {
-          FT_TS_Byte*  ss = s;
-          FT_TS_Byte*  tt = t;
-          FT_TS_UInt   j;
+    case FT_TS_PIXEL_MODE_BGRA:
+      target->num_grays = 256;
 
+      for ( i = source->rows; i > 0; i-- )
+      {
+        ft_bitmap_convert_bgra( s, t, width );
 
-          /* get the full bytes */
-          for ( j = source->width >> 2; j > 0; j-- )
-          {
-            FT_TS_Int  val = ss[0];
+        s += source->pitch;
+        t += target->pitch;
+      }
+      break;
 
+    default:
+      ;
+    }
+  }
 
-            tt[0] = (FT_TS_Byte)( ( val & 0xC0 ) >> 6 );
-            tt[1] = (FT_TS_Byte)( ( val & 0x30 ) >> 4 );
-            tt[2] = (FT_TS_Byte)( ( val & 0x0C ) >> 2 );
-            tt[3] = (FT_TS_Byte)( ( val & 0x03 ) );
 
-            ss += 1;
-            tt += 4;
-          }
+  /* documentation is in ftbitmap.h */
 
-          j = source->width & 3;
-          if ( j > 0 )
-          {
-            FT_TS_Int  val = ss[0];
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Bitmap_Convert( FT_TS_Library        library,
+                     const FT_TS_Bitmap  *source,
+                     FT_TS_Bitmap        *target,
+                     FT_TS_Int            alignment )
+  {
+    FT_TS_Error   error = FT_TS_Err_Ok;
+    FT_TS_Memory  memory;
 
 
-            for ( ; j > 0; j-- )
-            {
-              tt[0]  = (FT_TS_Byte)( ( val & 0xC0 ) >> 6 );
-              val  <<= 2;
-              tt    += 1;
-            }
-          }
+    if ( !library )
+      return FT_TS_THROW( Invalid_Library_Handle );
 
-          s += source->pitch;
-          t += target->pitch;
-        }
-      }
-      break;
+    if ( !source || !target )
+      return FT_TS_THROW( Invalid_Argument );
 
+    memory = library->memory;
 
+    switch ( source->pixel_mode )
+    {
+    case FT_TS_PIXEL_MODE_MONO:
+    case FT_TS_PIXEL_MODE_GRAY:
+    case FT_TS_PIXEL_MODE_GRAY2:
     case FT_TS_PIXEL_MODE_GRAY4:
+    case FT_TS_PIXEL_MODE_LCD:
+    case FT_TS_PIXEL_MODE_LCD_V:
+    case FT_TS_PIXEL_MODE_BGRA:
       {
-        FT_TS_UInt  i;
-
+        FT_TS_Int    pad, old_target_pitch, target_pitch;
+        FT_TS_ULong  old_size;
 
-        target->num_grays = 16;
 
-        for ( i = source->rows; i > 0; i-- )
-        {
-          FT_TS_Byte*  ss = s;
-          FT_TS_Byte*  tt = t;
-          FT_TS_UInt   j;
+        old_target_pitch = target->pitch;
+        if ( old_target_pitch < 0 )
+          old_target_pitch = -old_target_pitch;
 
+        old_size = target->rows * (FT_TS_UInt)old_target_pitch;
 
-          /* get the full bytes */
-          for ( j = source->width >> 1; j > 0; j-- )
-          {
-            FT_TS_Int  val = ss[0];
+        target->pixel_mode = FT_TS_PIXEL_MODE_GRAY;
+        target->rows       = source->rows;
+        target->width      = source->width;
 
+        pad = 0;
+        if ( alignment > 0 )
+        {
+          pad = (FT_TS_Int)source->width % alignment;
+          if ( pad != 0 )
+            pad = alignment - pad;
+        }
 
-            tt[0] = (FT_TS_Byte)( ( val & 0xF0 ) >> 4 );
-            tt[1] = (FT_TS_Byte)( ( val & 0x0F ) );
+        target_pitch = (FT_TS_Int)source->width + pad;
 
-            ss += 1;
-            tt += 2;
-          }
+        if ( target_pitch > 0                                               &&
+             (FT_TS_ULong)target->rows > FT_TS_ULONG_MAX / (FT_TS_ULong)target_pitch )
+          return FT_TS_THROW( Invalid_Argument );
 
-          if ( source->width & 1 )
-            tt[0] = (FT_TS_Byte)( ( ss[0] & 0xF0 ) >> 4 );
+        if ( FT_TS_QREALLOC( target->buffer,
+                          old_size, target->rows * (FT_TS_UInt)target_pitch ) )
+          return error;
 
-          s += source->pitch;
-          t += target->pitch;
-        }
+        target->pitch = target->pitch < 0 ? -target_pitch : target_pitch;
       }
       break;
 
+    default:
+      error = FT_TS_THROW( Invalid_Argument );
+    }
 
-    case FT_TS_PIXEL_MODE_BGRA:
-      {
-        FT_TS_UInt  i;
+    if ( !error )
+      ft_bitmap_convert_pixels( source, target );
 
+    return error;
+  }
 
-        target->num_grays = 256;
 
-        for ( i = source->rows; i > 0; i-- )
-        {
-          FT_TS_Byte*  ss = s;
-          FT_TS_Byte*  tt = t;
-          FT_TS_UInt   j;
+  /* documentation is in ftbitmap.h */
 
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Bitmap_Convert_Into( const FT_TS_Bitmap*  source,
+                          FT_TS_Bitmap*        target )
+  {
+    FT_TS_Int  target_pitch;
 
-          for ( j = source->width; j > 0; j-- )
-          {
-            tt[0] = ft_gray_for_premultiplied_srgb_bgra( ss );
 
-            ss += 4;
-            tt += 1;
-          }
+    if ( !source || !target )
+      return FT_TS_THROW( Invalid_Argument );
 
-          s += source->pitch;
-          t += target->pitch;
-        }
-      }
+    switch ( source->pixel_mode )
+    {
+    case FT_TS_PIXEL_MODE_MONO:
+    case FT_TS_PIXEL_MODE_GRAY:
+    case FT_TS_PIXEL_MODE_GRAY2:
+    case FT_TS_PIXEL_MODE_GRAY4:
+    case FT_TS_PIXEL_MODE_LCD:
+    case FT_TS_PIXEL_MODE_LCD_V:
+    case FT_TS_PIXEL_MODE_BGRA:
       break;
 
     default:
-      ;
+      return FT_TS_THROW( Invalid_Argument );
     }
 
-    return error;
+    target_pitch = target->pitch;
+    if ( target_pitch < 0 )
+      target_pitch = -target_pitch;
+
+    if ( (FT_TS_UInt)target_pitch < source->width ||
+         ( !target->buffer && source->rows && source->width ) )
+      return FT_TS_THROW( Invalid_Argument );
+
+    target->pixel_mode = FT_TS_PIXEL_MODE_GRAY;
+    target->rows       = source->rows;
+    target->width      = source->width;
+
+    ft_bitmap_convert_pixels( source, target );
+
+    return FT_TS_Err_Ok;
   }
 
 
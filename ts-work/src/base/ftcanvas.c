@@ -0,0 +1,1336 @@
+/****************************************************************************
+ *
+ * ftcanvas.c
+ *
+ *   FreeType glyph rendering into client surfaces (body).
+ *
+ * Copyright (C) 2022 by
+ * David Turner, Robert Wilhelm, and Werner Lemberg.
+ *
+ * This file is part of the FreeType project, and may only be used,
+ * modified, and distributed under the terms of the FreeType project
+ * license, LICENSE.TXT.  By continuing to use, modify, or distribute
+ * this file you indicate that you have read the license and
+ * understand and accept it fully.
+ *
+ */
+
+
+#include <freetype/ftcanvas.h>
+#include <freetype/ftoutln.h>
+#include <freetype/internal/ftdebug.h>
+#include <freetype/internal/ftobjs.h>
+
+
+  typedef struct FT_TS_Canvas_TargetRec_*  FT_TS_Canvas_Target;
+
+  /* blend `count' pixels at `dst' with constant coverage `cover' */
+  typedef void
+  (*FT_TS_Canvas_BlendFunc)( FT_TS_Canvas_Target  target,
+                             FT_TS_Byte*          dst,
+                             FT_TS_UInt           count,
+                             FT_TS_UInt           cover );
+
+  /* blend a single premultiplied BGRA pixel at `dst' */
+  typedef void
+  (*FT_TS_Canvas_BlendColorFunc)( FT_TS_Canvas_Target  target,
+                                  FT_TS_Byte*          dst,
+                                  const FT_TS_Byte*    src );
+
+
+  /* the clipped canvas, with the pixel writers of its format */
+  typedef struct  FT_TS_Canvas_TargetRec_
+  {
+    FT_TS_Byte*                  origin;   /* top row */
+    FT_TS_Int                    pitch;
+    FT_TS_UInt                   bpp;      /* bytes per pixel */
+
+    FT_TS_Int                    min_x;    /* clip box; max is exclusive */
+    FT_TS_Int                    min_y;
+    FT_TS_Int                    max_x;
+    FT_TS_Int                    max_y;
+
+    FT_TS_Int                    x;        /* position of outline origin */
+    FT_TS_Int                    y;
+
+    FT_TS_UInt                   blue;     /* glyph color */
+    FT_TS_UInt                   green;
+    FT_TS_UInt                   red;
+    FT_TS_UInt                   alpha;
+
+    FT_TS_Canvas_BlendFunc       blend;
+    FT_TS_Canvas_BlendColorFunc  blend_color;
+
+  } FT_TS_Canvas_TargetRec;
+
+
+  /* compute a * b / 255, rounded, for values in the range 0..255 */
+  static FT_TS_UInt
+  ft_canvas_mul( FT_TS_UInt  a,
+                 FT_TS_UInt  b )
+  {
+    FT_TS_UInt  t = a * b + 128;
+
+
+    return ( t + ( t >> 8 ) ) >> 8;
+  }
+
+
+  /*************************************************************************/
+  /*                                                                       */
+  /* Pixel writers.  All glyph pixels are composited with the `over'       */
+  /* operator; for RGB24 canvases, which have no alpha channel, this       */
+  /* amounts to interpolating between glyph color and background.          */
+  /*                                                                       */
+  /*************************************************************************/
+
+  static void
+  ft_canvas_blend_a8( FT_TS_Canvas_Target  target,
+                      FT_TS_Byte*          dst,
+                      FT_TS_UInt           count,
+                      FT_TS_UInt           cover )
+  {
+    FT_TS_UInt  a = ft_canvas_mul( target->alpha, cover );
+
+
+    if ( a == 255 )
+      FT_TS_MEM_SET( dst, 0xFF, count );
+    else if ( a )
+    {
+      FT_TS_UInt  ia = 255 - a;
+
+
+      for ( ; count > 0; count--, dst++ )
+        dst[0] = (FT_TS_Byte)( a + ft_canvas_mul( dst[0], ia ) );
+    }
+  }
+
+
+  static void
+  ft_canvas_blend_bgra32( FT_TS_Canvas_Target  target,
+                          FT_TS_Byte*          dst,
+                          FT_TS_UInt           count,
+                          FT_TS_UInt           cover )
+  {
+    FT_TS_UInt  a = ft_canvas_mul( target->alpha, cover );
+    FT_TS_UInt  b, g, r, ia;
+
+
+    if ( !a )
+      return;
+
+    b  = ft_canvas_mul( target->blue,  a );
+    g  = ft_canvas_mul( target->green, a );
+    r  = ft_canvas_mul( target->red,   a );
+    ia = 255 - a;
+
+    if ( !ia )
+    {
+      for ( ; count > 0; count--, dst += 4 )
+      {
+        dst[0] = (FT_TS_Byte)b;
+        dst[1] = (FT_TS_Byte)g;
+        dst[2] = (FT_TS_Byte)r;
+        dst[3] = 0xFF;
+      }
+    }
+    else
+    {
+      for ( ; count > 0; count--, dst += 4 )
+      {
+        dst[0] = (FT_TS_Byte)( b + ft_canvas_mul( dst[0], ia ) );
+        dst[1] = (FT_TS_Byte)( g + ft_canvas_mul( dst[1], ia ) );
+        dst[2] = (FT_TS_Byte)( r + ft_canvas_mul( dst[2], ia ) );
+        dst[3] = (FT_TS_Byte)( a + ft_canvas_mul( dst[3], ia ) );
+      }
+    }
+  }
+
+
+  static void
+  ft_canvas_blend_rgb24( FT_TS_Canvas_Target  target,
+                         FT_TS_Byte*          dst,
+                         FT_TS_UInt           count,
+                         FT_TS_UInt           cover )
+  {
+    FT_TS_UInt  a = ft_canvas_mul( target->alpha, cover );
+    FT_TS_UInt  r, g, b, ia;
+
+
+    if ( !a )
+      return;
+
+    r  = ft_canvas_mul( target->red,   a );
+    g  = ft_canvas_mul( target->green, a );
+    b  = ft_canvas_mul( target->blue,  a );
+    ia = 255 - a;
+
+    for ( ; count > 0; count--, dst += 3 )
+    {
+      dst[0] = (FT_TS_Byte)( r + ft_canvas_mul( dst[0], ia ) );
+      dst[1] = (FT_TS_Byte)( g + ft_canvas_mul( dst[1], ia ) );
+      dst[2] = (FT_TS_Byte)( b + ft_canvas_mul( dst[2], ia ) );
+    }
+  }
+
+
+  static void
+  ft_canvas_blend_color_a8( FT_TS_Canvas_Target  target,
+                            FT_TS_Byte*          dst,
+                            const FT_TS_Byte*    src )
+  {
+    FT_TS_UInt  a = ft_canvas_mul( src[3], target->alpha );
+
+
+    dst[0] = (FT_TS_Byte)( a + ft_canvas_mul( dst[0], 255 - a ) );
+  }
+
+
+  static void
+  ft_canvas_blend_color_bgra32( FT_TS_Canvas_Target  target,
+                                FT_TS_Byte*          dst,
+                                const FT_TS_Byte*    src )
+  {
+    FT_TS_UInt  fade = target->alpha;
+    FT_TS_UInt  ia   = 255 - ft_canvas_mul( src[3], fade );
+
+
+    dst[0] = (FT_TS_Byte)( ft_canvas_mul( src[0], fade ) +
+                           ft_canvas_mul( dst[0], ia ) );
+    dst[1] = (FT_TS_Byte)( ft_canvas_mul( src[1], fade ) +
+                           ft_canvas_mul( dst[1], ia ) );
+    dst[2] = (FT_TS_Byte)( ft_canvas_mul( src[2], fade ) +
+                           ft_canvas_mul( dst[2], ia ) );
+    dst[3] = (FT_TS_Byte)( ft_canvas_mul( src[3], fade ) +
+                           ft_canvas_mul( dst[3], ia ) );
+  }
+
+
+  static void
+  ft_canvas_blend_color_rgb24( FT_TS_Canvas_Target  target,
+                               FT_TS_Byte*          dst,
+                               const FT_TS_Byte*    src )
+  {
+    FT_TS_UInt  fade = target->alpha;
+    FT_TS_UInt  ia   = 255 - ft_canvas_mul( src[3], fade );
+
+
+    dst[0] = (FT_TS_Byte)( ft_canvas_mul( src[2], fade ) +
+                           ft_canvas_mul( dst[0], ia ) );
+    dst[1] = (FT_TS_Byte)( ft_canvas_mul( src[1], fade ) +
+                           ft_canvas_mul( dst[1], ia ) );
+    dst[2] = (FT_TS_Byte)( ft_canvas_mul( src[0], fade ) +
+                           ft_canvas_mul( dst[2], ia ) );
+  }
+
+
+  /* validate `canvas' and set up `target' for it */
+  static FT_TS_Error
+  ft_canvas_target_init( FT_TS_Canvas_Target  target,
+                         FT_TS_Canvas         canvas )
+  {
+    FT_TS_BBox*  clip;
+
+
+    if ( !canvas || !canvas->buffer ||
+         canvas->width < 0          ||
+         canvas->rows < 0           )
+      return FT_TS_THROW( Invalid_Argument );
+
+    switch ( canvas->format )
+    {
+    case FT_TS_CANVAS_FORMAT_A8:
+      target->bpp         = 1;
+      target->blend       = ft_canvas_blend_a8;
+      target->blend_color = ft_canvas_blend_color_a8;
+      break;
+
+    case FT_TS_CANVAS_FORMAT_BGRA32:
+      target->bpp         = 4;
+      target->blend       = ft_canvas_blend_bgra32;
+      target->blend_color = ft_canvas_blend_color_bgra32;
+      break;
+
+    case FT_TS_CANVAS_FORMAT_RGB24:
+      target->bpp         = 3;
+      target->blend       = ft_canvas_blend_rgb24;
+      target->blend_color = ft_canvas_blend_color_rgb24;
+      break;
+
+    default:
+      return FT_TS_THROW( Invalid_Argument );
+    }
+
+    target->origin = canvas->buffer;
+    target->pitch  = canvas->pitch;
+
+    target->min_x = 0;
+    target->min_y = 0;
+    target->max_x = canvas->width;
+    target->max_y = canvas->rows;
+
+    clip = &canvas->clip;
+    if ( clip->xMin || clip->yMin || clip->xMax || clip->yMax )
+    {
+      if ( clip->xMin > target->min_x )
+        target->min_x = (FT_TS_Int)clip->xMin;
+      if ( clip->yMin > target->min_y )
+        target->min_y = (FT_TS_Int)clip->yMin;
+      if ( clip->xMax < target->max_x )
+        target->max_x = (FT_TS_Int)clip->xMax;
+      if ( clip->yMax < target->max_y )
+        target->max_y = (FT_TS_Int)clip->yMax;
+    }
+
+    target->blue  = canvas->color.blue;
+    target->green = canvas->color.green;
+    target->red   = canvas->color.red;
+    target->alpha = canvas->color.alpha;
+
+    target->x = 0;
+    target->y = 0;
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* the span callback of the smooth rasterizer; `y' is an outline row */
+  static void
+  ft_canvas_gray_spans( int                y,
+                        int                count,
+                        const FT_TS_Span*  spans,
+                        void*              user )
+  {
+    FT_TS_Canvas_Target  target = (FT_TS_Canvas_Target)user;
+    FT_TS_Int            row    = target->y - 1 - y;
+    FT_TS_Byte*          line;
+
+
+    /* the raster clip box should make this test redundant */
+    if ( row < target->min_y || row >= target->max_y )
+      return;
+
+    line = target->origin + (FT_TS_Long)row * target->pitch;
+
+    for ( ; count > 0; count--, spans++ )
+    {
+      FT_TS_Int  x0 = target->x + spans->x;
+      FT_TS_Int  x1 = x0 + spans->len;
+
+
+      if ( x0 < target->min_x )
+        x0 = target->min_x;
+      if ( x1 > target->max_x )
+        x1 = target->max_x;
+
+      if ( x0 < x1 )
+        target->blend( target,
+                       line + (FT_TS_UInt)x0 * target->bpp,
+                       (FT_TS_UInt)( x1 - x0 ),
+                       spans->coverage );
+    }
+  }
+
+
+  /* documentation is in ftcanvas.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Canvas_Render_Outline( FT_TS_Library   library,
+                               FT_TS_Canvas    canvas,
+                               FT_TS_Outline*  outline,
+                               FT_TS_Int       x,
+                               FT_TS_Int       y )
+  {
+    FT_TS_Error             error;
+    FT_TS_Canvas_TargetRec  target;
+    FT_TS_Raster_Params     params;
+    FT_TS_BBox              cbox;
+    FT_TS_Pos               x_shift, y_shift;
+
+
+    if ( !library )
+      return FT_TS_THROW( Invalid_Library_Handle );
+
+    if ( !outline )
+      return FT_TS_THROW( Invalid_Outline );
+
+    error = ft_canvas_target_init( &target, canvas );
+    if ( error )
+      return error;
+
+    if ( !outline->n_points || !target.alpha )
+      return FT_TS_Err_Ok;
+
+    FT_TS_ZERO( &params );
+
+    /* intersect the outline's pixel box with the clip box, */
+    /* the latter converted to outline coordinates          */
+    FT_TS_Outline_Get_CBox( outline, &cbox );
+
+    params.clip_box.xMin = FT_TS_MAX( cbox.xMin >> 6,
+                                      target.min_x - x );
+    params.clip_box.xMax = FT_TS_MIN( ( cbox.xMax + 63 ) >> 6,
+                                      target.max_x - x );
+    params.clip_box.yMin = FT_TS_MAX( cbox.yMin >> 6,
+                                      y - target.max_y );
+    params.clip_box.yMax = FT_TS_MIN( ( cbox.yMax + 63 ) >> 6,
+                                      y - target.min_y );
+
+    if ( params.clip_box.xMin >= params.clip_box.xMax ||
+         params.clip_box.yMin >= params.clip_box.yMax )
+      return FT_TS_Err_Ok;
+
+    /* Like `ft_smooth_render', move the outline's pixel box to the   */
+    /* origin so that the rasterizer sees the same coordinates as for */
+    /* `slot->bitmap'; its results are not exactly invariant under    */
+    /* translations to negative coordinates.                          */
+    x_shift = cbox.xMin >> 6;
+    y_shift = cbox.yMin >> 6;
+
+    params.clip_box.xMin -= x_shift;
+    params.clip_box.xMax -= x_shift;
+    params.clip_box.yMin -= y_shift;
+    params.clip_box.yMax -= y_shift;
+
+    target.x = x + (FT_TS_Int)x_shift;
+    target.y = y - (FT_TS_Int)y_shift;
+
+    params.flags      = FT_TS_RASTER_FLAG_AA     |
+                        FT_TS_RASTER_FLAG_DIRECT |
+                        FT_TS_RASTER_FLAG_CLIP;
+    params.gray_spans = ft_canvas_gray_spans;
+    params.user       = &target;
+
+    FT_TS_Outline_Translate( outline, -64 * x_shift, -64 * y_shift );
+
+    error = FT_TS_Outline_Render( library, outline, &params );
+
+    FT_TS_Outline_Translate( outline, 64 * x_shift, 64 * y_shift );
+
+    return error;
+  }
+
+
+  /* documentation is in ftcanvas.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Canvas_Draw_Bitmap( FT_TS_Canvas         canvas,
+                            const FT_TS_Bitmap*  bitmap,
+                            FT_TS_Int            x,
+                            FT_TS_Int            y )
+  {
+    FT_TS_Error             error;
+    FT_TS_Canvas_TargetRec  target;
+    FT_TS_UInt              scale;
+    FT_TS_Int               x0, x1, y0, y1;
+    FT_TS_Int               row;
+    FT_TS_Byte*             src;
+    FT_TS_Int               src_pitch;
+
+
+    if ( !bitmap )
+      return FT_TS_THROW( Invalid_Argument );
+
+    error = ft_canvas_target_init( &target, canvas );
+    if ( error )
+      return error;
+
+    /* `scale' maps pixel values to coverage; 0 means that gray */
+    /* values must be divided by `num_grays - 1'                */
+    switch ( bitmap->pixel_mode )
+    {
+    case FT_TS_PIXEL_MODE_MONO:
+      scale = 255;
+      break;
+
+    case FT_TS_PIXEL_MODE_GRAY2:
+      scale = 85;
+      break;
+
+    case FT_TS_PIXEL_MODE_GRAY4:
+      scale = 17;
+      break;
+
+    case FT_TS_PIXEL_MODE_GRAY:
+      scale = 1;
+      if ( bitmap->num_grays > 1 && bitmap->num_grays < 256 )
+        scale = 0;
+      break;
+
+    case FT_TS_PIXEL_MODE_BGRA:
+      scale = 0;
+      break;
+
+    default:
+      return FT_TS_THROW( Invalid_Argument );
+    }
+
+    if ( !bitmap->buffer || !target.alpha )
+      return FT_TS_Err_Ok;
+
+    /* the canvas area covered by the bitmap */
+    x0 = FT_TS_MAX( x, target.min_x );
+    y0 = FT_TS_MAX( y, target.min_y );
+    x1 = FT_TS_MIN( x + (FT_TS_Int)bitmap->width, target.max_x );
+    y1 = FT_TS_MIN( y + (FT_TS_Int)bitmap->rows,  target.max_y );
+
+    if ( x0 >= x1 || y0 >= y1 )
+      return FT_TS_Err_Ok;
+
+    /* go to the source row of `y0' */
+    src_pitch = bitmap->pitch;
+    src       = bitmap->buffer;
+    if ( src_pitch < 0 )
+      src -= (FT_TS_Long)src_pitch * (FT_TS_Int)( bitmap->rows - 1 );
+    src += (FT_TS_Long)src_pitch * ( y0 - y );
+
+    for ( row = y0; row < y1; row++, src += src_pitch )
+    {
+      FT_TS_Byte* line = target.origin + (FT_TS_Long)row * target.pitch;
+      FT_TS_Int  col  = x0;
+
+
+      if ( bitmap->pixel_mode == FT_TS_PIXEL_MODE_BGRA )
+      {
+        const FT_TS_Byte*p = src + 4 * ( x0 - x );
+
+
+        for ( ; col < x1; col++, p += 4 )
+          if ( p[3] )
+            target.blend_color( &target,
+                                line + (FT_TS_UInt)col * target.bpp,
+                                p );
+        continue;
+      }
+
+      /* collect runs of equal coverage */
+      while ( col < x1 )
+      {
+        FT_TS_UInt  cover = 0;
+        FT_TS_Int   start = col;
+
+
+        for ( ; col < x1; col++ )
+        {
+          FT_TS_UInt  i = (FT_TS_UInt)( col - x );
+          FT_TS_UInt  c;
+
+
+          switch ( bitmap->pixel_mode )
+          {
+          case FT_TS_PIXEL_MODE_MONO:
+            c = ( src[i >> 3] >> ( 7 - ( i & 7 ) ) ) & 1;
+            break;
+
+          case FT_TS_PIXEL_MODE_GRAY2:
+            c = ( src[i >> 2] >> ( 6 - 2 * ( i & 3 ) ) ) & 3;
+            break;
+
+          case FT_TS_PIXEL_MODE_GRAY4:
+            c = ( src[i >> 1] >> ( 4 - 4 * ( i & 1 ) ) ) & 15;
+            break;
+
+          default:
+            c = src[i];
+            if ( !scale )
+            {
+              if ( c >= bitmap->num_grays )
+                c = bitmap->num_grays - 1U;
+              c = c * 255 / ( bitmap->num_grays - 1U );
+            }
+          }
+
+          if ( scale > 1 )
+            c *= scale;
+
+          if ( col == start )
+            cover = c;
+          else if ( c != cover )
+            break;
+        }
+
+        if ( cover )
+          target.blend( &target,
+                        line + (FT_TS_UInt)start * target.bpp,
+                        (FT_TS_UInt)( col - start ),
+                        cover );
+      }
+    }
+
+    return FT_TS_Err_Ok;
+  }
+
+
+  /* documentation is in ftcanvas.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Canvas_Render_Glyph( FT_TS_Canvas     canvas,
+                             FT_TS_GlyphSlot  slot,
+                             FT_TS_Int        x,
+                             FT_TS_Int        y )
+  {
+    FT_TS_Error  error;
+
+
+    if ( !slot )
+      return FT_TS_THROW( Invalid_Slot_Handle );
+
+    if ( slot->format == FT_TS_GLYPH_FORMAT_OUTLINE )
+      return FT_TS_Canvas_Render_Outline( slot->library, canvas,
+                                          &slot->outline, x, y );
+
+    if ( slot->format != FT_TS_GLYPH_FORMAT_BITMAP )
+    {
+      error = FT_TS_Render_Glyph( slot, FT_TS_RENDER_MODE_NORMAL );
+      if ( error )
+        return error;
+    }
+
+    return FT_TS_Canvas_Draw_Bitmap( canvas, &slot->bitmap,
+                                     x + slot->bitmap_left,
+                                     y - slot->bitmap_top );
+  }
+
+
+  /* the tile being rendered by the smooth rasterizer in direct mode */
+  typedef struct  FT_TS_Canvas_TileRec_
+  {
+    const FT_TS_Bitmap*  bitmap;
+    FT_TS_Int            x;      /* leftmost column, in outline pixels */
+    FT_TS_Int            y;      /* row above the top row, likewise    */
+    FT_TS_Bool           inked;
+
+  } FT_TS_Canvas_TileRec, *FT_TS_Canvas_Tile;
+
+
+  /* the span callback for tiles; spans never exceed the clip box */
+  static void
+  ft_canvas_tile_spans( int                y,
+                        int                count,
+                        const FT_TS_Span*  spans,
+                        void*              user )
+  {
+    FT_TS_Canvas_Tile  tile = (FT_TS_Canvas_Tile)user;
+    FT_TS_Byte*        line = tile->bitmap->buffer +
+                                ( tile->y - 1 - y ) * tile->bitmap->pitch;
+
+
+    for ( ; count > 0; count--, spans++ )
+    {
+      if ( !spans->coverage )
+        continue;
+
+      FT_TS_MEM_SET( line + spans->x - tile->x,
+                     spans->coverage,
+                     spans->len );
+      tile->inked = TRUE;
+    }
+  }
+
+
+  /* Return the contours of `outline' whose control boxes `cboxes'    */
+  /* intersect `box': NULL if there are none, `outline' itself if all */
+  /* of them do, and otherwise `sub', to whose arrays (large enough   */
+  /* for the whole outline) they are copied.  A closed contour does   */
+  /* not change any pixel outside of its control box, so the result   */
+  /* renders the same pixels within `box' as `outline'.               */
+  static FT_TS_Outline*
+  ft_canvas_tile_contours( FT_TS_Outline*     outline,
+                           const FT_TS_BBox*  cboxes,
+                           const FT_TS_BBox*  box,
+                           FT_TS_Outline*     sub )
+  {
+    FT_TS_Int  c, first, n_contours;
+
+
+    n_contours = 0;
+
+    for ( c = 0; c < outline->n_contours; c++ )
+      if ( cboxes[c].xMax >= box->xMin && cboxes[c].xMin <= box->xMax &&
+           cboxes[c].yMax >= box->yMin && cboxes[c].yMin <= box->yMax )
+        n_contours++;
+
+    if ( !n_contours )
+      return NULL;
+
+    if ( n_contours == outline->n_contours )
+      return outline;
+
+    sub->n_points   = 0;
+    sub->n_contours = 0;
+    sub->flags      = outline->flags;
+
+    first = 0;
+
+    for ( c = 0; c < outline->n_contours; c++ )
+    {
+      FT_TS_Int  last = outline->contours[c];
+
+
+      if ( cboxes[c].xMax >= box->xMin && cboxes[c].xMin <= box->xMax &&
+           cboxes[c].yMax >= box->yMin && cboxes[c].yMin <= box->yMax )
+      {
+        FT_TS_Int  count = last - first + 1;
+
+
+        FT_TS_ARRAY_COPY( sub->points + sub->n_points,
+                          outline->points + first, count );
+        FT_TS_ARRAY_COPY( sub->tags + sub->n_points,
+                          outline->tags + first, count );
+
+        sub->n_points += (short)count;
+
+        sub->contours[sub->n_contours++] = (short)( sub->n_points - 1 );
+      }
+
+      first = last + 1;
+    }
+
+    return sub;
+  }
+
+
+  /* documentation is in ftcanvas.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Render_Glyph_Tiles( FT_TS_GlyphSlot    slot,
+                            FT_TS_Render_Mode  render_mode,
+                            FT_TS_UInt         tile_width,
+                            FT_TS_UInt         tile_height,
+                            FT_TS_Tile_Func    func,
+                            void*              user )
+  {
+    FT_TS_Error   error;
+    FT_TS_Memory  memory;
+
+    FT_TS_Outline*  outline;
+    FT_TS_Outline   sub;
+    FT_TS_BBox*     cboxes = NULL;
+    FT_TS_Bitmap    saved;
+    FT_TS_Int       saved_left, saved_top;
+    FT_TS_Int       c, n, first;
+
+    FT_TS_Int  left, top, width, rows;
+    FT_TS_Int  tx, ty;
+
+    FT_TS_Bitmap          tile;
+    FT_TS_Canvas_TileRec  rec;
+    FT_TS_Raster_Params   params;
+
+
+    if ( !slot )
+      return FT_TS_THROW( Invalid_Slot_Handle );
+
+    if ( slot->format != FT_TS_GLYPH_FORMAT_OUTLINE )
+      return FT_TS_THROW( Invalid_Glyph_Format );
+
+    if ( !func || !tile_height )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( render_mode != FT_TS_RENDER_MODE_NORMAL &&
+         render_mode != FT_TS_RENDER_MODE_LIGHT  &&
+         render_mode != FT_TS_RENDER_MODE_MONO   )
+      return FT_TS_THROW( Cannot_Render_Glyph );
+
+    memory  = slot->library->memory;
+    outline = &slot->outline;
+
+    /* get the pixel box `FT_TS_Render_Glyph' would use, leaving the     */
+    /* slot's bitmap unchanged; unlike `FT_TS_Render_Glyph', we accept   */
+    /* boxes too large for a single bitmap since tiles are clipped to it */
+    saved      = slot->bitmap;
+    saved_left = slot->bitmap_left;
+    saved_top  = slot->bitmap_top;
+
+    (void)ft_glyphslot_preset_bitmap( slot, render_mode, NULL );
+
+    left  = slot->bitmap_left;
+    top   = slot->bitmap_top;
+    width = (FT_TS_Int)slot->bitmap.width;
+    rows  = (FT_TS_Int)slot->bitmap.rows;
+
+    slot->bitmap      = saved;
+    slot->bitmap_left = saved_left;
+    slot->bitmap_top  = saved_top;
+
+    if ( !width || !rows )
+      return FT_TS_Err_Ok;
+
+    if ( !tile_width || tile_width > (FT_TS_UInt)width )
+      tile_width = (FT_TS_UInt)width;
+    if ( tile_height > (FT_TS_UInt)rows )
+      tile_height = (FT_TS_UInt)rows;
+
+    FT_TS_ZERO( &tile );
+
+    tile.pixel_mode = render_mode == FT_TS_RENDER_MODE_MONO
+                        ? FT_TS_PIXEL_MODE_MONO
+                        : FT_TS_PIXEL_MODE_GRAY;
+    tile.num_grays  = 256;
+    tile.pitch      = render_mode == FT_TS_RENDER_MODE_MONO
+                        ? (FT_TS_Int)( ( tile_width + 15 ) >> 4 ) << 1
+                        : (FT_TS_Int)tile_width;
+
+    FT_TS_ZERO( &sub );
+
+    if ( FT_TS_QALLOC_MULT( tile.buffer, tile_height, tile.pitch ) ||
+         FT_TS_QNEW_ARRAY( cboxes, outline->n_contours )           ||
+         FT_TS_QNEW_ARRAY( sub.points, outline->n_points )         ||
+         FT_TS_QNEW_ARRAY( sub.tags, outline->n_points )           ||
+         FT_TS_QNEW_ARRAY( sub.contours, outline->n_contours )     )
+      goto Fail;
+
+    FT_TS_ZERO( &params );
+
+    /* Move the pixel box to the origin, as `ft_smooth_render' does.  In */
+    /* gray mode, the outline stays there and each tile is selected by   */
+    /* the clip box, so that tiles exactly match the whole bitmap.  The  */
+    /* abscissae of spans only have 16 bits, though; tiles of wider      */
+    /* glyphs (which `FT_TS_Render_Glyph' rejects) are therefore moved   */
+    /* to the origin like in mono mode, which can change gray levels     */
+    /* slightly since the rasterizer is not exactly shift-invariant.     */
+    FT_TS_Outline_Translate( outline, -64 * left, -64 * ( top - rows ) );
+
+    /* Each tile only gets the contours near it, so that the rasterizer */
+    /* does not decompose the whole outline again for every tile.       */
+    first = 0;
+    for ( c = 0; c < outline->n_contours; c++ )
+    {
+      FT_TS_Int  last = outline->contours[c];
+
+
+      cboxes[c].xMin = cboxes[c].xMax = outline->points[first].x;
+      cboxes[c].yMin = cboxes[c].yMax = outline->points[first].y;
+
+      for ( n = first + 1; n <= last; n++ )
+      {
+        FT_TS_Vector*  vec = outline->points + n;
+
+
+        if ( vec->x < cboxes[c].xMin )
+          cboxes[c].xMin = vec->x;
+        if ( vec->x > cboxes[c].xMax )
+          cboxes[c].xMax = vec->x;
+        if ( vec->y < cboxes[c].yMin )
+          cboxes[c].yMin = vec->y;
+        if ( vec->y > cboxes[c].yMax )
+          cboxes[c].yMax = vec->y;
+      }
+
+      first = last + 1;
+    }
+
+    if ( tile.pixel_mode == FT_TS_PIXEL_MODE_GRAY )
+    {
+      params.flags      = FT_TS_RASTER_FLAG_AA     |
+                          FT_TS_RASTER_FLAG_DIRECT |
+                          FT_TS_RASTER_FLAG_CLIP;
+      params.gray_spans = ft_canvas_tile_spans;
+      params.user       = &rec;
+
+      rec.bitmap = &tile;
+    }
+    else
+      params.target = &tile;
+
+    for ( ty = 0; ty < rows; ty += (FT_TS_Int)tile_height )
+    {
+      tile.rows = (unsigned int)FT_TS_MIN( (FT_TS_Int)tile_height,
+                                           rows - ty );
+
+      for ( tx = 0; tx < width; tx += (FT_TS_Int)tile_width )
+      {
+        FT_TS_Bool      inked, mono;
+        FT_TS_BBox      box;
+        FT_TS_Outline*  source;
+        FT_TS_Int       sx, sy;
+
+        /* the tile's bottom left corner, in outline pixels */
+        FT_TS_Int  bx = tx;
+        FT_TS_Int  by = rows - ty - (FT_TS_Int)tile.rows;
+
+
+        tile.width = (unsigned int)FT_TS_MIN( (FT_TS_Int)tile_width,
+                                              width - tx );
+
+        /* the margin of one pixel keeps the contours that can cause */
+        /* drop-out pixels in the tile                               */
+        box.xMin = 64 * (FT_TS_Pos)( bx - 1 );
+        box.yMin = 64 * (FT_TS_Pos)( by - 1 );
+        box.xMax = 64 * (FT_TS_Pos)( bx + (FT_TS_Int)tile.width + 1 );
+        box.yMax = 64 * (FT_TS_Pos)( by + (FT_TS_Int)tile.rows + 1 );
+
+        source = ft_canvas_tile_contours( outline, cboxes, &box, &sub );
+        if ( !source )
+          continue;
+
+        FT_TS_MEM_ZERO( tile.buffer, tile.rows * (FT_TS_UInt)tile.pitch );
+
+        /* the shift moving the tile to the origin, where needed */
+        mono = FT_TS_BOOL( tile.pixel_mode == FT_TS_PIXEL_MODE_MONO );
+        sx   = mono || width > 0x7FFF ? bx : 0;
+        sy   = mono ? by : 0;
+
+        if ( sx || sy )
+          FT_TS_Outline_Translate( source, -64 * sx, -64 * sy );
+
+        if ( !mono )
+        {
+          params.clip_box.xMin = bx - sx;
+          params.clip_box.yMin = by;
+          params.clip_box.xMax = bx - sx + (FT_TS_Int)tile.width;
+          params.clip_box.yMax = by + (FT_TS_Int)tile.rows;
+
+          rec.x     = bx - sx;
+          rec.y     = by + (FT_TS_Int)tile.rows;
+          rec.inked = FALSE;
+
+          error = FT_TS_Outline_Render( slot->library, source, &params );
+          inked = rec.inked;
+        }
+        else
+        {
+          FT_TS_Byte*  p;
+          FT_TS_Byte*  limit;
+
+
+          error = FT_TS_Outline_Render( slot->library, source, &params );
+
+          p     = tile.buffer;
+          limit = p + tile.rows * (FT_TS_UInt)tile.pitch;
+          while ( p < limit && !*p )
+            p++;
+          inked = p < limit;
+        }
+
+        if ( sx || sy )
+          FT_TS_Outline_Translate( source, 64 * sx, 64 * sy );
+
+        if ( !error && inked )
+          error = func( &tile, left + tx, top - ty, user );
+
+        if ( error )
+          goto Exit;
+      }
+    }
+
+  Exit:
+    FT_TS_Outline_Translate( outline, 64 * left, 64 * ( top - rows ) );
+
+  Fail:
+    FT_TS_FREE( tile.buffer );
+    FT_TS_FREE( cboxes );
+    FT_TS_FREE( sub.points );
+    FT_TS_FREE( sub.tags );
+    FT_TS_FREE( sub.contours );
+
+    return error;
+  }
+
+
+  /* a glyph of a page, with its pixel box in page coordinates */
+  typedef struct  FT_TS_Canvas_PageItemRec_
+  {
+    FT_TS_Outline*  outline;
+    FT_TS_UInt      glyph_index;
+
+    FT_TS_Int       left;      /* pixel box; `top' is a page row */
+    FT_TS_Int       top;
+    FT_TS_Int       width;
+    FT_TS_Int       rows;
+
+    FT_TS_Pos       x_shift;   /* moves the pixel box to the origin */
+    FT_TS_Pos       y_shift;
+
+    FT_TS_Byte*     bits;      /* glyph bitmap if straddling bands */
+    FT_TS_Int       pitch;
+
+    struct FT_TS_Canvas_PageItemRec_*  link;
+
+  } FT_TS_Canvas_PageItemRec, *FT_TS_Canvas_PageItem;
+
+
+  /* glyphs with outline first, the others sorted by glyph index */
+  FT_TS_COMPARE_DEF( int )
+  ft_canvas_compare_index( const void*  a,
+                           const void*  b )
+  {
+    FT_TS_Canvas_PageItem  ia = (FT_TS_Canvas_PageItem)a;
+    FT_TS_Canvas_PageItem  ib = (FT_TS_Canvas_PageItem)b;
+
+
+    if ( !ia->outline != !ib->outline )
+      return ia->outline ? -1 : 1;
+
+    if ( ia->outline )
+      return 0;
+
+    return ia->glyph_index < ib->glyph_index ? -1
+                                             : ia->glyph_index >
+                                                 ib->glyph_index;
+  }
+
+
+  /* visible glyphs first, sorted by top row */
+  FT_TS_COMPARE_DEF( int )
+  ft_canvas_compare_top( const void*  a,
+                         const void*  b )
+  {
+    FT_TS_Canvas_PageItem  ia = (FT_TS_Canvas_PageItem)a;
+    FT_TS_Canvas_PageItem  ib = (FT_TS_Canvas_PageItem)b;
+
+
+    if ( !ia->outline != !ib->outline )
+      return ia->outline ? -1 : 1;
+
+    return ia->top < ib->top ? -1 : ia->top > ib->top;
+  }
+
+
+  /* the monochrome pixel box, as computed for a glyph slot; */
+  /* return TRUE if the glyph is too large                    */
+  static FT_TS_Bool
+  ft_canvas_mono_box( FT_TS_Outline*  outline,
+                      FT_TS_BBox*     pbox )
+  {
+    FT_TS_GlyphSlotRec  dummy;
+    FT_TS_BBox          cbox;
+
+
+    FT_TS_Outline_Get_CBox( outline, &cbox );
+
+    FT_TS_ZERO( &dummy );
+    dummy.format = FT_TS_GLYPH_FORMAT_OUTLINE;
+
+    if ( ft_glyphslot_preset_bitmap_cbox( &dummy,
+                                          FT_TS_RENDER_MODE_MONO,
+                                          &cbox,
+                                          NULL ) )
+      return TRUE;
+
+    pbox->xMin = dummy.bitmap_left;
+    pbox->yMax = dummy.bitmap_top;
+    pbox->xMax = pbox->xMin + (FT_TS_Pos)dummy.bitmap.width;
+    pbox->yMin = pbox->yMax - (FT_TS_Pos)dummy.bitmap.rows;
+
+    return FALSE;
+  }
+
+
+  /* `or' the rows of a glyph bitmap that fall into the band */
+  static void
+  ft_canvas_page_copy( const FT_TS_Bitmap*    band,
+                       FT_TS_Int              band_top,
+                       FT_TS_Canvas_PageItem  item )
+  {
+    FT_TS_Int  r     = FT_TS_MAX( item->top, band_top );
+    FT_TS_Int  limit = FT_TS_MIN( item->top + item->rows,
+                                  band_top + (FT_TS_Int)band->rows );
+    FT_TS_Int  shift = item->left & 7;
+    FT_TS_Int  n     = ( item->width + 7 ) >> 3;
+
+
+    for ( ; r < limit; r++ )
+    {
+      const FT_TS_Byte*  src = item->bits + ( r - item->top ) * item->pitch;
+      FT_TS_Byte*        dst = band->buffer + ( r - band_top ) * band->pitch;
+      FT_TS_Int          i;
+
+
+      if ( item->left >= 0                                        &&
+           item->left + item->width <= (FT_TS_Int)band->width )
+      {
+        dst += item->left >> 3;
+
+        /* bits past the glyph width are zero, so `dst[i + 1]' */
+        /* is only written within the band's width             */
+        for ( i = 0; i < n; i++ )
+        {
+          FT_TS_UInt  b = src[i];
+
+
+          if ( !b )
+            continue;
+
+          dst[i] |= (FT_TS_Byte)( b >> shift );
+          if ( shift && ( b << ( 8 - shift ) ) & 0xFF )
+            dst[i + 1] |= (FT_TS_Byte)( b << ( 8 - shift ) );
+        }
+      }
+      else
+      {
+        /* glyph crossing the left or right page edge */
+        FT_TS_Int  c   = FT_TS_MAX( 0, -item->left );
+        FT_TS_Int  end = FT_TS_MIN( item->width,
+                                    (FT_TS_Int)band->width - item->left );
+
+
+        for ( ; c < end; c++ )
+        {
+          FT_TS_Int  x = item->left + c;
+
+
+          if ( src[c >> 3] & ( 0x80 >> ( c & 7 ) ) )
+            dst[x >> 3] |= (FT_TS_Byte)( 0x80 >> ( x & 7 ) );
+        }
+      }
+    }
+  }
+
+
+  /* documentation is in ftcanvas.h */
+
+  FT_TS_EXPORT_DEF( FT_TS_Error )
+  FT_TS_Render_Page_Bands( FT_TS_Library         library,
+                           const FT_TS_PageRec*  page,
+                           FT_TS_Bitmap*         band,
+                           FT_TS_Band_Func       func,
+                           void*                 user )
+  {
+    FT_TS_Error   error;
+    FT_TS_Memory  memory;
+
+    FT_TS_Canvas_PageItem  items   = NULL;
+    FT_TS_Canvas_PageItem  carried = NULL;   /* glyphs straddling bands */
+    FT_TS_UInt             count, next, i;
+
+    FT_TS_Glyph*    loaded       = NULL;     /* glyphs given by index */
+    FT_TS_UInt      num_loaded   = 0;
+    FT_TS_Bool      have_last    = FALSE;
+    FT_TS_UInt      last_index   = 0;
+    FT_TS_Outline*  last_outline = NULL;
+
+    FT_TS_Bitmap         cur;
+    FT_TS_Int            band_top;
+    FT_TS_Raster_Params  params;
+
+
+    if ( !library )
+      return FT_TS_THROW( Invalid_Library_Handle );
+
+    if ( !page || !band || !func )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( band->pixel_mode != FT_TS_PIXEL_MODE_MONO ||
+         !band->buffer                          ||
+         !band->rows                            ||
+         band->width > 0xFFFFU                  ||
+         band->pitch < (FT_TS_Int)( ( band->width + 7 ) >> 3 ) )
+      return FT_TS_THROW( Invalid_Argument );
+
+    if ( page->num_glyphs && !page->glyphs )
+      return FT_TS_THROW( Invalid_Argument );
+
+    memory = library->memory;
+    count  = page->num_glyphs;
+
+    if ( FT_TS_NEW_ARRAY( items, count )  ||
+         FT_TS_NEW_ARRAY( loaded, count ) )
+      goto Exit;
+
+    for ( i = 0; i < count; i++ )
+    {
+      items[i].outline     = page->glyphs[i].outline;
+      items[i].glyph_index = page->glyphs[i].glyph_index;
+      items[i].left        = page->glyphs[i].x;
+      items[i].top         = page->glyphs[i].y;
+    }
+
+    /* load each glyph given by index only once */
+    ft_qsort( items, count, sizeof ( *items ), ft_canvas_compare_index );
+
+    for ( i = 0; i < count; i++ )
+    {
+      FT_TS_GlyphSlot  slot;
+
+
+      if ( items[i].outline )
+        continue;
+
+      if ( have_last && items[i].glyph_index == last_index )
+      {
+        items[i].outline = last_outline;
+        continue;
+      }
+
+      if ( !page->face )
+      {
+        error = FT_TS_THROW( Invalid_Face_Handle );
+        goto Exit;
+      }
+
+      error = FT_TS_Load_Glyph( page->face,
+                                items[i].glyph_index,
+                                page->load_flags | FT_TS_LOAD_NO_BITMAP );
+      if ( error )
+        goto Exit;
+
+      have_last    = TRUE;
+      last_index   = items[i].glyph_index;
+      last_outline = NULL;
+
+      slot = page->face->glyph;
+      if ( slot->format != FT_TS_GLYPH_FORMAT_OUTLINE )
+        continue;
+
+      error = FT_TS_Get_Glyph( slot, &loaded[num_loaded] );
+      if ( error )
+        goto Exit;
+
+      last_outline     = &( (FT_TS_OutlineGlyph)loaded[num_loaded] )->outline;
+      items[i].outline = last_outline;
+      num_loaded++;
+    }
+
+    /* compute pixel boxes and drop glyphs outside of the page */
+    for ( i = 0; i < count; i++ )
+    {
+      FT_TS_Canvas_PageItem  item = items + i;
+      FT_TS_BBox             pbox;
+
+
+      if ( !item->outline )
+        continue;
+
+      if ( ft_canvas_mono_box( item->outline, &pbox ) )
+      {
+        error = FT_TS_THROW( Raster_Overflow );
+        goto Exit;
+      }
+
+      item->left   += (FT_TS_Int)pbox.xMin;
+      item->top    -= (FT_TS_Int)pbox.yMax;
+      item->width   = (FT_TS_Int)( pbox.xMax - pbox.xMin );
+      item->rows    = (FT_TS_Int)( pbox.yMax - pbox.yMin );
+      item->x_shift = -64 * pbox.xMin;
+      item->y_shift = -64 * pbox.yMin;
+
+      if ( item->left >= (FT_TS_Int)band->width    ||
+           item->left + item->width <= 0            ||
+           item->top >= (FT_TS_Int)page->rows       ||
+           item->top + item->rows <= 0              )
+        item->outline = NULL;
+    }
+
+    /* bin the glyphs by band: each glyph is rendered */
+    /* when the band containing its top row is        */
+    ft_qsort( items, count, sizeof ( *items ), ft_canvas_compare_top );
+    while ( count > 0 && !items[count - 1].outline )
+      count--;
+
+    FT_TS_ZERO( &params );
+    cur  = *band;
+    next = 0;
+
+    for ( band_top = 0; band_top < (FT_TS_Int)page->rows;
+          band_top += (FT_TS_Int)band->rows )
+    {
+      FT_TS_Int               band_end;
+      FT_TS_Canvas_PageItem*  pitem;
+
+
+      band_end = FT_TS_MIN( band_top + (FT_TS_Int)band->rows,
+                            (FT_TS_Int)page->rows );
+      cur.rows = (unsigned int)( band_end - band_top );
+
+      FT_TS_MEM_ZERO( cur.buffer, cur.rows * (FT_TS_UInt)cur.pitch );
+
+      /* glyphs rendered in a previous band */
+      pitem = &carried;
+      while ( *pitem )
+      {
+        FT_TS_Canvas_PageItem  item = *pitem;
+
+
+        ft_canvas_page_copy( &cur, band_top, item );
+
+        if ( item->top + item->rows <= band_end )
+        {
+          FT_TS_FREE( item->bits );
+          *pitem = item->link;
+        }
+        else
+          pitem = &item->link;
+      }
+
+      /* glyphs starting in this band */
+      for ( ; next < count && items[next].top < band_end; next++ )
+      {
+        FT_TS_Canvas_PageItem  item = items + next;
+        FT_TS_Bitmap           target;
+
+
+        FT_TS_ZERO( &target );
+        target.pixel_mode = FT_TS_PIXEL_MODE_MONO;
+        target.rows       = (unsigned int)item->rows;
+        params.target     = &target;
+
+        if ( item->top >= band_top                              &&
+             item->top + item->rows <= band_end                 &&
+             item->left >= 0                                    &&
+             item->left + item->width <= (FT_TS_Int)cur.width   &&
+             !( item->left & 7 )                                )
+        {
+          /* Render byte-aligned glyphs directly into the band; for */
+          /* others, drop-out pixels could appear left of the box.  */
+          target.buffer = cur.buffer + ( item->top - band_top ) * cur.pitch +
+                            ( item->left >> 3 );
+          target.width  = (unsigned int)item->width;
+          target.pitch  = cur.pitch;
+        }
+        else
+        {
+          /* render into a glyph bitmap, kept while the glyph */
+          /* extends into the next bands                      */
+          item->pitch = ( ( item->width + 15 ) >> 4 ) << 1;
+          if ( FT_TS_ALLOC_MULT( item->bits, item->rows, item->pitch ) )
+            goto Exit;
+
+          target.buffer = item->bits;
+          target.width  = (unsigned int)item->width;
+          target.pitch  = item->pitch;
+        }
+
+        FT_TS_Outline_Translate( item->outline, item->x_shift, item->y_shift );
+        error = FT_TS_Outline_Render( library, item->outline, &params );
+        FT_TS_Outline_Translate( item->outline,
+                                 -item->x_shift, -item->y_shift );
+
+        if ( item->bits )
+        {
+          if ( !error )
+            ft_canvas_page_copy( &cur, band_top, item );
+
+          if ( !error && item->top + item->rows > band_end )
+          {
+            item->link = carried;
+            carried    = item;
+          }
+          else
+            FT_TS_FREE( item->bits );
+        }
+
+        if ( error )
+          goto Exit;
+      }
+
+      error = func( &cur, band_top, user );
+      if ( error )
+        goto Exit;
+    }
+
+  Exit:
+    for ( ; carried; carried = carried->link )
+      FT_TS_FREE( carried->bits );
+
+    for ( i = 0; i < num_loaded; i++ )
+      FT_TS_Done_Glyph( loaded[i] );
+
+    FT_TS_FREE( loaded );
+    FT_TS_FREE( items );
+
+    return error;
+  }
+
+
+/* END */
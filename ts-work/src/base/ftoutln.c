@@ -457,46 +457,19 @@
   FT_TS_Outline_Get_CBox( const FT_TS_Outline*  outline,
                        FT_TS_BBox           *acbox )
   {
-    FT_TS_Pos  xMin, yMin, xMax, yMax;
-
-
     if ( outline && acbox )
     {
       if ( outline->n_points == 0 )
       {
-        xMin = 0;
-        yMin = 0;
-        xMax = 0;
-        yMax = 0;
+        acbox->xMin = 0;
+        acbox->xMax = 0;
+        acbox->yMin = 0;
+        acbox->yMax = 0;
       }
       else
-      {
-        FT_TS_Vector*  vec   = outline->points;
-        FT_TS_Vector*  limit = vec + outline->n_points;
-
-
-        xMin = xMax = vec->x;
-        yMin = yMax = vec->y;
-        vec++;
-
-        for ( ; vec < limit; vec++ )
-        {
-          FT_TS_Pos  x, y;
-
-
-          x = vec->x;
-          if ( x < xMin ) xMin = x;
-          if ( x > xMax ) xMax = x;
-
-          y = vec->y;
-          if ( y < yMin ) yMin = y;
-          if ( y > yMax ) yMax = y;
-        }
-      }
-      acbox->xMin = xMin;
-      acbox->xMax = xMax;
-      acbox->yMin = yMin;
-      acbox->yMax = yMax;
+        FT_TS_Vectors_Get_CBox( outline->points,
+                             (FT_TS_UShort)outline->n_points,
+                             acbox );
     }
   }
 
@@ -706,18 +679,31 @@
   FT_TS_Outline_Transform( const FT_TS_Outline*  outline,
                         const FT_TS_Matrix*   matrix )
   {
-    FT_TS_Vector*  vec;
-    FT_TS_Vector*  limit;
-
-
     if ( !outline || !matrix || !outline->points )
       return;
 
-    vec   = outline->points;
-    limit = vec + outline->n_points;
+    FT_TS_Vectors_Transform( outline->points, (FT_TS_UShort)outline->n_points,
+                             matrix, 0, 0 );
+  }
 
-    for ( ; vec < limit; vec++ )
-      FT_TS_Vector_Transform( vec, matrix );
+
+  /* documentation is in ftoutln.h */
+
+  FT_TS_EXPORT_DEF( void )
+  FT_TS_Outline_Transform_Translate( const FT_TS_Outline*  outline,
+                                  const FT_TS_Matrix*   matrix,
+                                  const FT_TS_Vector*   delta )
+  {
+    static const FT_TS_Matrix  identity = { 0x10000L, 0, 0, 0x10000L };
+
+
+    if ( !outline || !outline->points )
+      return;
+
+    FT_TS_Vectors_Transform( outline->points, (FT_TS_UShort)outline->n_points,
+                             matrix ? matrix : &identity,
+                             delta ? delta->x : 0,
+                             delta ? delta->y : 0 );
   }
 
 
@@ -888,6 +874,25 @@
 #endif /* 0 */
 
 
+  /* Compute `FT_TS_MulDiv( a, b, c )' for a lateral shift component,     */
+  /* skipping the division for the ratios 0 and +/-1 that corners of    */
+  /* axis-aligned segments produce.  `c' is never zero here.            */
+  static FT_TS_Pos
+  ft_outline_lateral( FT_TS_Pos    a,
+                      FT_TS_Pos    b,
+                      FT_TS_Fixed  c )
+  {
+    if ( a == 0 )
+      return 0;
+    if ( a == c )
+      return b;
+    if ( a == -c )
+      return NEG_LONG( b );
+
+    return FT_TS_MulDiv( a, b, c );
+  }
+
+
   /* documentation is in ftoutln.h */
 
 /**
@@ -924,6 +929,7 @@
     FT_TS_Vector*      points;
     FT_TS_Int          c, first, last;
     FT_TS_Orientation  orientation;
+    FT_TS_Bool         same;
 
 
     if ( !outline )
@@ -944,12 +950,14 @@
     }
 
     points = outline->points;
+    same   = FT_TS_BOOL( xstrength == ystrength );
 
     first = 0;
     for ( c = 0; c < outline->n_contours; c++ )
     {
       FT_TS_Vector  in, out, anchor, shift;
-      FT_TS_Fixed   l_in, l_out, l_anchor = 0, l, q, d;
+      FT_TS_Fixed   l_in, l_out, l_anchor = 0, l, q, d, ld;
+      FT_TS_Bool    x_by_d, y_by_d;
       FT_TS_Int     i, j, k;
 
 
@@ -1000,29 +1008,29 @@
             shift.x = in.y + out.y;
             shift.y = in.x + out.x;
 
+            /* restrict shift magnitude to better handle collapsing segments */
+            q = FT_TS_MulFix( out.x, in.y ) - FT_TS_MulFix( out.y, in.x );
+
             if ( orientation == FT_TS_ORIENTATION_TRUETYPE )
+            {
               shift.x = -shift.x;
+              q       = -q;
+            }
             else
               shift.y = -shift.y;
 
-            /* restrict shift magnitude to better handle collapsing segments */
-            q = FT_TS_MulFix( out.x, in.y ) - FT_TS_MulFix( out.y, in.x );
-            if ( orientation == FT_TS_ORIENTATION_TRUETYPE )
-              q = -q;
-
-            l = FT_TS_MIN( l_in, l_out );
+            l  = FT_TS_MIN( l_in, l_out );
+            ld = FT_TS_MulFix( l, d );
 
             /* non-strict inequalities avoid divide-by-zero when q == l == 0 */
-            if ( FT_TS_MulFix( xstrength, q ) <= FT_TS_MulFix( l, d ) )
-              shift.x = FT_TS_MulDiv( shift.x, xstrength, d );
-            else
-              shift.x = FT_TS_MulDiv( shift.x, l, q );
-
-
-            if ( FT_TS_MulFix( ystrength, q ) <= FT_TS_MulFix( l, d ) )
-              shift.y = FT_TS_MulDiv( shift.y, ystrength, d );
-            else
-              shift.y = FT_TS_MulDiv( shift.y, l, q );
+            x_by_d = FT_TS_BOOL( FT_TS_MulFix( xstrength, q ) <= ld );
+            y_by_d = same ? x_by_d
+                          : FT_TS_BOOL( FT_TS_MulFix( ystrength, q ) <= ld );
+
+            shift.x = x_by_d ? ft_outline_lateral( shift.x, xstrength, d )
+                             : ft_outline_lateral( shift.x, l, q );
+            shift.y = y_by_d ? ft_outline_lateral( shift.y, ystrength, d )
+                             : ft_outline_lateral( shift.y, l, q );
           }
           else
             shift.x = shift.y = 0;